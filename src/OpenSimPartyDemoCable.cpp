@@ -25,17 +25,36 @@
 THIS DOESN'T WORK YET */
 
 #include "Simbody.h"
+#include "trajectory.hpp"
 
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 using std::cout; using std::endl;
 
 using namespace SimTK;
 
 // This gets called periodically to dump out interesting things about
-// the cables and the system as a whole. It also saves states so that we
-// can play back at the end.
-static Array_<State> saveStates;
+// the cables and the system as a whole. It also records the trajectory so
+// that we can play back at the end (and analyse it after exit).
+static const char* recordingPath = "OpenSimPartyDemoCable.traj";
+static std::unique_ptr<osim::Trajectory_writer> recording;
+
+// Recorded columns: time, each q, each u, then the cable's outputs. Replay
+// only needs q and u; everything else in the State is recomputed.
+static std::vector<std::string> recordedColumns(const State& state) {
+    std::vector<std::string> names = {"time"};
+    for (int i=0; i < state.getNQ(); ++i)
+        names.push_back("q" + std::to_string(i));
+    for (int i=0; i < state.getNU(); ++i)
+        names.push_back("u" + std::to_string(i));
+    names.push_back("cable_length");
+    names.push_back("cable_tension");
+    return names;
+}
+
 class ShowStuff : public PeriodicEventReporter {
 public:
     ShowStuff(const MultibodySystem& mbs, 
@@ -65,14 +84,23 @@ public:
             mbs.calcEnergy(state)
                 + cable1.getDissipatedEnergy(state),
             cpuTime());
-        saveStates.push_back(state);
+
+        if (!recording) return;
+        row.clear();
+        row.push_back(state.getTime());
+        for (int i=0; i < state.getNQ(); ++i) row.push_back(state.getQ()[i]);
+        for (int i=0; i < state.getNU(); ++i) row.push_back(state.getU()[i]);
+        row.push_back(path1.getCableLength(state));
+        row.push_back(cable1.getTension(state));
+        recording->append(row);
     }
 private:
     const MultibodySystem&  mbs;
     CableSpring             cable1;
+    mutable std::vector<double> row;
 };
 
-int oss_expt_party() {
+int oss_expt_party(int, char**) {
   try {    
     // Create the system.   
     MultibodySystem system;
@@ -229,7 +257,7 @@ int oss_expt_party() {
     // path1.setIntegratedCableLengthDot(state, path1.getCableLength(state));
 
     // Simulate it.
-    saveStates.clear(); saveStates.reserve(2000);
+    recording = std::make_unique<osim::Trajectory_writer>(recordingPath, recordedColumns(state));
 
     // RungeKutta3Integrator integ(system);
     RungeKuttaMersonIntegrator integ(system);
@@ -247,12 +275,29 @@ int oss_expt_party() {
          << "s simulated in " << realTime()-startTime
          << "s elapsed.\n";
 
+    recording->finish();
+    recording.reset();
+
+    // Replay straight out of the mapped file: each frame's q and u are
+    // written into one reusable State, rather than keeping a State per frame.
+    osim::Trajectory traj(recordingPath);
+    cout << "recorded " << traj.num_rows() << " states to " << recordingPath << "\n";
+    State replayState = integ.getState();
+    std::vector<double> replayRow(traj.num_columns());
+    const int nq = replayState.getNQ(), nu = replayState.getNU();
+
     while (true) {
         cout << "Hit ENTER FOR REPLAY, Q to quit ...";
         const char ch = getchar();
         if (ch=='q' || ch=='Q') break;
-        for (unsigned i=0; i < saveStates.size(); ++i)
-            viz.report(saveStates[i]);
+        for (std::uint64_t i=0; i < traj.num_rows(); ++i) {
+            traj.read_row(i, replayRow);
+            replayState.setTime(replayRow[0]);
+            for (int j=0; j < nq; ++j) replayState.updQ()[j] = replayRow[1+j];
+            for (int j=0; j < nu; ++j) replayState.updU()[j] = replayRow[1+nq+j];
+            system.realize(replayState, Stage::Position);
+            viz.report(replayState);
+        }
     }
 
   } catch (const std::exception& e) {
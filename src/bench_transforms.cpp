@@ -0,0 +1,50 @@
+#include "opensim_wrapper.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static const char* usage = R"(usage: osim-snippets bench_xforms <model.osim> [min_decorations] [iterations]
+
+Times computing the world transform of every decoration in a model, both one
+decoration at a time (look up the body, compose in double precision, convert)
+and via a per-state body-transform table plus a batched float compose. The
+batched compose is timed both with SSE2 (where the target has it) and as a
+plain glm loop. The model's decorations are repeated until there are at least
+`min_decorations` (default: 5000) of them.
+
+Timings are only meaningful in an optimized build (e.g. configure with
+-DCMAKE_BUILD_TYPE=Release).
+)";
+
+int oss_bench_xforms(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << usage << std::endl;
+        return -1;
+    }
+
+    std::string model = argv[2];
+    std::size_t min_decorations = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5000;
+    int iterations = argc > 4 ? std::atoi(argv[4]) : 1000;
+
+    osim::Transform_benchmark b;
+    try {
+        b = osim::benchmark_transforms(model, min_decorations, iterations);
+    } catch (std::exception const& ex) {
+        std::cerr << model << ": failed: " << ex.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "decorations:     " << b.num_decorations << std::endl
+              << "bodies:          " << b.num_bodies << std::endl
+              << "iterations:      " << iterations << std::endl
+              << "per-decoration:  " << b.per_decoration_us << " us/pose" << std::endl
+              << "batched:         " << b.batched_us << " us/pose (" << b.compose_isa << ")" << std::endl
+              << "batched, scalar: " << b.batched_scalar_us << " us/pose" << std::endl
+              << "speedup:         " << (b.batched_us > 0.0 ? b.per_decoration_us / b.batched_us : 0.0) << "x" << std::endl
+              << "SIMD speedup:    " << (b.batched_us > 0.0 ? b.batched_scalar_us / b.batched_us : 0.0) << "x" << std::endl
+              << "max difference:  " << b.max_abs_difference << std::endl;
+
+    return 0;
+}
@@ -1,129 +1,382 @@
 #include <OpenSim/OpenSim.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace SimTK;
 using namespace OpenSim;
 
+namespace {
+    // Parameters of the bicep curl that the sweep varies
+    struct Bicep_curl_params final {
+        double wrap_radius = 0.4;
+        Vec3 wrap_translation{-0.1, -0.9, 0};
+        double max_isometric_force = 200;
+
+        // the excitation steps from 0.1 to 1 between these times
+        double step_start = 1;
+        double step_end = 3;
+    };
+
+    // Builds the bicep curl model into `model`. If `wrap_path` is set, the
+    // biceps path wraps over the pulley (otherwise, the pulley is only
+    // decoration).
+    void build_bicep_curl(Model& model, Bicep_curl_params const& params, bool wrap_path) {
+        model.setName("bicep_curl");
+
+        // Create two links, each with a mass of 1 kg, center of mass at the body's
+        // origin, and moments and products of inertia of zero.
+        auto* humerus = new OpenSim::Body(
+            "humerus",
+            1,
+            Vec3(0),
+            Inertia(0));
+
+        auto* radius  = new OpenSim::Body(
+            "radius",
+            1,
+            Vec3(0),
+            Inertia(0));
+
+        // Connect the bodies with pin joints. Assume each body is 1 m long.
+        auto* shoulder = new PinJoint(
+            "shoulder",
+
+            model.getGround(),
+            Vec3(0),
+            Vec3(0),
+
+            *humerus,
+            Vec3(0, 1, 0),
+            Vec3(0));
+
+        auto* elbow = new PinJoint(
+            "elbow",
+
+            *humerus,
+            Vec3(0),
+            Vec3(0),
+
+            *radius,
+            Vec3(0, 1 , 0),
+            Vec3(0));
+
+        // Add a muscle that flexes the elbow.
+
+        auto* biceps = new Millard2012EquilibriumMuscle(
+            "biceps",
+            params.max_isometric_force,
+            0.6,
+            0.55,
+            0);
+
+        auto* wc = new WrapCylinder{};
+        wc->setName("pulley1");
+        wc->set_radius(params.wrap_radius);
+        wc->set_length(0.1);
+        wc->set_translation(params.wrap_translation);
+
+        model.updGround().addWrapObject(wc);
+
+        GeometryPath& p = biceps->updGeometryPath();
+        if (wrap_path) {
+            p.addPathWrap(*wc);
+        }
+        p.appendNewPathPoint("origin",    *humerus, Vec3(0, 0.8, 0));
+        auto* tmp = p.appendNewPathPoint("tmp",    *humerus, Vec3(0, 0.8, 0));
+        // this isn't done programatically in OpenSim anywhere. All of it is done
+        // via the osim files.
+        /*ConditionalPathPoint cpp{};
+        cpp.setRangeMin(1);
+        cpp.setRangeMax(2);
+        cpp.setLocation(Vec3(0, 0, 0));
+        cpp.setParentFrame(*humerus);
+        cpp.setName("this_is_a_terrible_api");
+        p.replacePathPoint(tmp, &cpp);
+        */
+        p.appendNewPathPoint("insertion", *radius,  Vec3(0, 0.7, 0));
+
+        // Add a controller that specifies the excitation of the muscle.
+        PrescribedController* brain = new PrescribedController();
+        brain->setName("brain");
+        brain->addActuator(*biceps);
+        // Muscle excitation is 0.1 until step_start, then increases to 1 by step_end.
+        brain->prescribeControlForActuator("biceps",
+                new StepFunction(params.step_start, params.step_end, 0.1, 1));
+
+        // Add components to the model.
+        model.addBody(humerus);
+        model.addBody(radius);
+        model.addJoint(shoulder);
+        model.addJoint(elbow);
+        model.addForce(biceps);
+        model.addController(brain);
+
+        // Add a console reporter to print the muscle fiber force and elbow angle.
+        /*
+        ConsoleReporter* reporter = new ConsoleReporter();
+        reporter->set_report_time_interval(1.0);
+        reporter->addToReport(biceps->getOutput("fiber_force"));
+        reporter->addToReport(
+            elbow->getCoordinate(PinJoint::Coord::RotationZ).getOutput("value"),
+            "elbow_angle");
+        model.addComponent(reporter);
+        */
+
+        // Add display geometry.
+        Ellipsoid bodyGeometry(0.1, 0.5, 0.1);
+        bodyGeometry.setColor(Gray);
+        // Attach an ellipsoid to a frame located at the center of each body.
+        PhysicalOffsetFrame* humerusCenter = new PhysicalOffsetFrame(
+            "humerusCenter", *humerus, Transform(Vec3(0, 0.5, 0)));
+        humerus->addComponent(humerusCenter);
+        humerusCenter->attachGeometry(bodyGeometry.clone());
+        PhysicalOffsetFrame* radiusCenter = new PhysicalOffsetFrame(
+            "radiusCenter", *radius, Transform(Vec3(0, 0.5, 0)));
+        radius->addComponent(radiusCenter);
+        radiusCenter->attachGeometry(bodyGeometry.clone());
+    }
+
+    // Changes the parameters of a (built, possibly initialized) bicep curl.
+    // The model must be re-initialized afterwards.
+    void set_bicep_curl_params(Model& model, Bicep_curl_params const& params) {
+        auto& wc = dynamic_cast<WrapCylinder&>(model.updGround().upd_WrapObjectSet().get("pulley1"));
+        wc.set_radius(params.wrap_radius);
+        wc.set_translation(params.wrap_translation);
+
+        model.updMuscles().get("biceps").setMaxIsometricForce(params.max_isometric_force);
+
+        // replaces the existing control function
+        auto& brain = dynamic_cast<PrescribedController&>(model.updControllerSet().get("brain"));
+        brain.prescribeControlForActuator("biceps",
+                new StepFunction(params.step_start, params.step_end, 0.1, 1));
+    }
+
+    // Initializes the model's system and returns its initial state
+    State& init_bicep_curl(Model& model) {
+        State& state = model.initSystem();
+        // Fix the shoulder at its default angle and begin with the elbow flexed.
+        model.getJointSet().get("shoulder").getCoordinate().setLocked(state, true);
+        model.getJointSet().get("elbow").getCoordinate().setValue(state, 0.5 * Pi);
+        model.equilibrateMuscles(state);
+        return state;
+    }
+
+    // An inclusive range of `n` evenly-spaced values, parsed from "a:b:n" (or
+    // just "a", for a single value)
+    struct Sweep_range final {
+        double lo;
+        double hi;
+        int n;
+
+        Sweep_range(double v) : lo{v}, hi{v}, n{1} {
+        }
+
+        Sweep_range(std::string const& s) {
+            char trailing;
+            if (std::sscanf(s.c_str(), "%lf:%lf:%d%c", &lo, &hi, &n, &trailing) == 3) {
+                if (n < 1) {
+                    throw std::runtime_error{s + ": range must have at least one value"};
+                }
+            } else if (std::sscanf(s.c_str(), "%lf%c", &lo, &trailing) == 1) {
+                hi = lo;
+                n = 1;
+            } else {
+                throw std::runtime_error{s + ": expected <value> or <from>:<to>:<n>"};
+            }
+        }
+
+        double operator[](int i) const noexcept {
+            return n == 1 ? lo : lo + (hi - lo) * i / (n - 1);
+        }
+    };
+
+    struct Sweep_options final {
+        Sweep_range radius{0.4};
+        Sweep_range tx{-0.1};
+        Sweep_range ty{-0.9};
+        Sweep_range force{200.0};
+        Sweep_range step_start{1.0};
+        Sweep_range step_end{3.0};
+        double duration = 10.0;
+        double sample_interval = 0.01;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        bool wrap_path = true;
+        std::string out;  // empty: stdout
+    };
+
+    // Every combination of the option ranges, innermost range last
+    std::vector<Bicep_curl_params> sweep_cases(Sweep_options const& opts) {
+        std::vector<Bicep_curl_params> cases;
+        for (int a = 0; a < opts.radius.n; ++a)
+        for (int b = 0; b < opts.tx.n; ++b)
+        for (int c = 0; c < opts.ty.n; ++c)
+        for (int d = 0; d < opts.force.n; ++d)
+        for (int e = 0; e < opts.step_start.n; ++e)
+        for (int f = 0; f < opts.step_end.n; ++f) {
+            Bicep_curl_params p;
+            p.wrap_radius = opts.radius[a];
+            p.wrap_translation = Vec3{opts.tx[b], opts.ty[c], 0};
+            p.max_isometric_force = opts.force[d];
+            p.step_start = opts.step_start[e];
+            p.step_end = opts.step_end[f];
+            cases.push_back(p);
+        }
+        return cases;
+    }
+
+    struct Case_result final {
+        double peak_fiber_force = 0;
+        double final_elbow_angle = 0;
+        double wall_ms = 0;
+        std::string error;
+    };
+
+    // Runs one case on a worker's own copy of the model, without a visualizer
+    Case_result run_case(Model& model, Bicep_curl_params const& params, Sweep_options const& opts) {
+        auto t0 = std::chrono::steady_clock::now();
+        Case_result rv;
+
+        try {
+            set_bicep_curl_params(model, params);
+            State& state = init_bicep_curl(model);
+
+            Muscle const& biceps = model.getMuscles().get("biceps");
+            Coordinate const& elbow = model.getJointSet().get("elbow").getCoordinate();
+
+            RungeKuttaMersonIntegrator integrator{model.getMultibodySystem()};
+            integrator.setAccuracy(1e-3);
+            TimeStepper stepper{model.getMultibodySystem(), integrator};
+            stepper.initialize(state);
+
+            // fiber force is sampled at a fixed interval, rather than at every
+            // (variable-length) integrator step, so peaks are comparable
+            // between cases
+            int num_samples = std::max(1, static_cast<int>(std::ceil(opts.duration / opts.sample_interval)));
+            for (int i = 0; i <= num_samples; ++i) {
+                if (i > 0) {
+                    stepper.stepTo(std::min(opts.duration, i * opts.sample_interval));
+                }
+                State const& s = integrator.getState();
+                model.realizeDynamics(s);
+                rv.peak_fiber_force = std::max(rv.peak_fiber_force, biceps.getFiberForce(s));
+            }
+            rv.final_elbow_angle = elbow.getValue(integrator.getState());
+        } catch (std::exception const& ex) {
+            rv.error = ex.what();
+        }
+
+        rv.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return rv;
+    }
+
+    // Work-stealing scheduler for a fixed set of cases
+    //
+    // Each worker owns a deque of case indices, which starts as a contiguous
+    // block of the cases. Workers pop from the back of their own deque and,
+    // once it's empty, steal from the front of the others'. Cases vary a lot
+    // in cost (a stiff case can take many times longer to integrate), so a
+    // static split would leave most cores idle at the end of a sweep. Cases
+    // never spawn cases, so a worker that finds every deque empty is done.
+    class Case_scheduler final {
+        struct alignas(64) Queue final {
+            std::mutex mutex;
+            std::deque<std::size_t> cases;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::atomic<std::size_t> num_steals{0};
+
+    public:
+        Case_scheduler(std::size_t num_cases, unsigned num_workers) {
+            for (unsigned w = 0; w < num_workers; ++w) {
+                auto q = std::make_unique<Queue>();
+                std::size_t begin = num_cases * w / num_workers;
+                std::size_t end = num_cases * (w + 1) / num_workers;
+                for (std::size_t i = begin; i < end; ++i) {
+                    q->cases.push_back(i);
+                }
+                queues.push_back(std::move(q));
+            }
+        }
+
+        // next case for `worker`, or false if there is none left anywhere
+        bool next(unsigned worker, std::size_t& out) {
+            {
+                Queue& own = *queues[worker];
+                std::lock_guard lock{own.mutex};
+                if (not own.cases.empty()) {
+                    out = own.cases.back();
+                    own.cases.pop_back();
+                    return true;
+                }
+            }
+
+            for (std::size_t i = 1; i < queues.size(); ++i) {
+                Queue& victim = *queues[(worker + i) % queues.size()];
+                std::lock_guard lock{victim.mutex};
+                if (not victim.cases.empty()) {
+                    out = victim.cases.front();
+                    victim.cases.pop_front();
+                    ++num_steals;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::size_t steals() const noexcept {
+            return num_steals;
+        }
+    };
+
+    constexpr char const* sweep_usage = R"(usage: osim-snippets sweep [options]
+
+Runs the bicep-curl wrapping experiment headlessly for every combination of
+the given parameters, in parallel, and writes one CSV row of summary metrics
+per case as soon as it finishes (so rows are not in case order).
+
+A parameter is either a single value or an inclusive range <from>:<to>:<n> of
+n evenly-spaced values.
+
+options:
+    --radius <r>        pulley wrap-cylinder radius (default: 0.4)
+    --tx <x>            pulley x translation (default: -0.1)
+    --ty <y>            pulley y translation (default: -0.9)
+    --force <f>         biceps max isometric force (default: 200)
+    --step-start <t>    time the excitation step starts (default: 1)
+    --step-end <t>      time the excitation step ends (default: 3)
+    --duration <t>      simulated time per case (default: 10)
+    --sample <dt>       fiber force sampling interval (default: 0.01)
+    --threads <n>       worker threads (default: number of cores)
+    --no-wrap           don't wrap the biceps over the pulley
+    --out <file>        write results to a file (default: stdout)
+)";
+}
+
 int oss_expt_wrapp(int argc, char** argv) {
     Model model;
-    model.setName("bicep_curl");
+    build_bicep_curl(model, Bicep_curl_params{}, false);
     model.setUseVisualizer(true);
 
-    // Create two links, each with a mass of 1 kg, center of mass at the body's
-    // origin, and moments and products of inertia of zero.
-    auto* humerus = new OpenSim::Body(
-        "humerus",
-        1,
-        Vec3(0),
-        Inertia(0));
-
-    auto* radius  = new OpenSim::Body(
-        "radius",
-        1,
-        Vec3(0),
-        Inertia(0));
-
-    // Connect the bodies with pin joints. Assume each body is 1 m long.
-    auto* shoulder = new PinJoint(
-        "shoulder",
-
-        model.getGround(),
-        Vec3(0),
-        Vec3(0),
-
-        *humerus,
-        Vec3(0, 1, 0),
-        Vec3(0));
-
-    auto* elbow = new PinJoint(
-        "elbow",
-
-        *humerus,
-        Vec3(0),
-        Vec3(0),
-
-        *radius,
-        Vec3(0, 1 , 0),
-        Vec3(0));
-
-    // Add a muscle that flexes the elbow.
-
-    auto* biceps = new Millard2012EquilibriumMuscle(
-        "biceps",
-        200,
-        0.6,
-        0.55,
-        0);
-
-    auto* wc = new WrapCylinder{};
-    wc->setName("pulley1");
-    wc->set_radius(0.4);
-    wc->set_length(0.1);
-    wc->set_translation(Vec3{-0.1, -0.9, 0});
-
-    model.updGround().addWrapObject(wc);
-
-    GeometryPath& p = biceps->updGeometryPath();
-    //p.addPathWrap(*wc);
-    p.appendNewPathPoint("origin",    *humerus, Vec3(0, 0.8, 0));
-    auto* tmp = p.appendNewPathPoint("tmp",    *humerus, Vec3(0, 0.8, 0));
-    // this isn't done programatically in OpenSim anywhere. All of it is done
-    // via the osim files.
-    /*ConditionalPathPoint cpp{};
-    cpp.setRangeMin(1);
-    cpp.setRangeMax(2);
-    cpp.setLocation(Vec3(0, 0, 0));
-    cpp.setParentFrame(*humerus);
-    cpp.setName("this_is_a_terrible_api");
-    p.replacePathPoint(tmp, &cpp);
-    */
-    p.appendNewPathPoint("insertion", *radius,  Vec3(0, 0.7, 0));
-
-    // Add a controller that specifies the excitation of the muscle.
-    PrescribedController* brain = new PrescribedController();
-    brain->addActuator(*biceps);
-    // Muscle excitation is 0.3 for the first 0.5 seconds, then increases to 1.
-    brain->prescribeControlForActuator("biceps",
-            new StepFunction(1, 3, 0.1, 1));
-
-    // Add components to the model.
-    model.addBody(humerus);
-    model.addBody(radius);
-    model.addJoint(shoulder);
-    model.addJoint(elbow);
-    model.addForce(biceps);
-    model.addController(brain);
-
-    // Add a console reporter to print the muscle fiber force and elbow angle.
-    /*
-    ConsoleReporter* reporter = new ConsoleReporter();
-    reporter->set_report_time_interval(1.0);
-    reporter->addToReport(biceps->getOutput("fiber_force"));
-    reporter->addToReport(
-        elbow->getCoordinate(PinJoint::Coord::RotationZ).getOutput("value"),
-        "elbow_angle");
-    model.addComponent(reporter);
-    */
-
-    // Add display geometry.
-    Ellipsoid bodyGeometry(0.1, 0.5, 0.1);
-    bodyGeometry.setColor(Gray);
-    // Attach an ellipsoid to a frame located at the center of each body.
-    PhysicalOffsetFrame* humerusCenter = new PhysicalOffsetFrame(
-        "humerusCenter", *humerus, Transform(Vec3(0, 0.5, 0)));
-    humerus->addComponent(humerusCenter);
-    humerusCenter->attachGeometry(bodyGeometry.clone());
-    PhysicalOffsetFrame* radiusCenter = new PhysicalOffsetFrame(
-        "radiusCenter", *radius, Transform(Vec3(0, 0.5, 0)));
-    radius->addComponent(radiusCenter);
-    radiusCenter->attachGeometry(bodyGeometry.clone());
-
-
     // Configure the model.
-    State& state = model.initSystem();
-    // Fix the shoulder at its default angle and begin with the elbow flexed.
-    shoulder->getCoordinate().setLocked(state, true);
-    elbow->getCoordinate().setValue(state, 0.5 * Pi);
-    model.equilibrateMuscles(state);
+    State& state = init_bicep_curl(model);
 
     // Configure the visualizer.
     model.updMatterSubsystem().setShowDefaultGeometry(true);
@@ -135,4 +388,147 @@ int oss_expt_wrapp(int argc, char** argv) {
     simulate(model, state, 10.0);
 
     return 0;
-};
+}
+
+int oss_sweep(int argc, char** argv) {
+    Sweep_options opts;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error{arg + ": missing value"};
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--radius") {
+                opts.radius = Sweep_range{value()};
+            } else if (arg == "--tx") {
+                opts.tx = Sweep_range{value()};
+            } else if (arg == "--ty") {
+                opts.ty = Sweep_range{value()};
+            } else if (arg == "--force") {
+                opts.force = Sweep_range{value()};
+            } else if (arg == "--step-start") {
+                opts.step_start = Sweep_range{value()};
+            } else if (arg == "--step-end") {
+                opts.step_end = Sweep_range{value()};
+            } else if (arg == "--duration") {
+                opts.duration = std::atof(value().c_str());
+            } else if (arg == "--sample") {
+                opts.sample_interval = std::atof(value().c_str());
+            } else if (arg == "--threads") {
+                opts.threads = static_cast<unsigned>(std::max(1, std::atoi(value().c_str())));
+            } else if (arg == "--no-wrap") {
+                opts.wrap_path = false;
+            } else if (arg == "--out") {
+                opts.out = value();
+            } else {
+                throw std::runtime_error{arg + ": unknown option"};
+            }
+        }
+        if (opts.duration <= 0 or opts.sample_interval <= 0) {
+            throw std::runtime_error{"--duration and --sample must be positive"};
+        }
+    } catch (std::exception const& ex) {
+        std::cerr << "sweep: " << ex.what() << std::endl << sweep_usage << std::endl;
+        return -1;
+    }
+
+    std::vector<Bicep_curl_params> cases = sweep_cases(opts);
+    unsigned num_workers = static_cast<unsigned>(std::min<std::size_t>(opts.threads, cases.size()));
+
+    std::ofstream out_file;
+    if (not opts.out.empty()) {
+        out_file.open(opts.out);
+        if (not out_file) {
+            std::cerr << "sweep: " << opts.out << ": cannot open for writing" << std::endl;
+            return -1;
+        }
+    }
+    std::ostream& out = opts.out.empty() ? std::cout : out_file;
+
+    // each worker gets its own copy of the model: OpenSim models (and their
+    // states) can't be shared between threads. Cloning is done up front, on
+    // this thread, because OpenSim's object registry isn't thread-safe.
+    Model base;
+    build_bicep_curl(base, Bicep_curl_params{}, opts.wrap_path);
+    base.finalizeFromProperties();
+    std::vector<std::unique_ptr<Model>> models;
+    for (unsigned w = 0; w < num_workers; ++w) {
+        models.emplace_back(base.clone());
+    }
+
+    std::cerr << "sweep: " << cases.size() << " cases on " << num_workers << " threads" << std::endl;
+
+    out << "case,radius,tx,ty,max_force,step_start,step_end,peak_fiber_force,final_elbow_angle,wall_ms,worker,error\n";
+    out.flush();
+
+    Case_scheduler scheduler{cases.size(), num_workers};
+    std::mutex out_mutex;
+    std::vector<double> busy_ms(num_workers, 0.0);
+    std::atomic<std::size_t> num_failed{0};
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    auto worker = [&](unsigned w) {
+        std::size_t i;
+        while (scheduler.next(w, i)) {
+            Bicep_curl_params const& p = cases[i];
+            Case_result r = run_case(*models[w], p, opts);
+            busy_ms[w] += r.wall_ms;
+            if (not r.error.empty()) {
+                ++num_failed;
+                std::replace(r.error.begin(), r.error.end(), ',', ';');
+                std::replace(r.error.begin(), r.error.end(), '\n', ' ');
+            }
+
+            // rows are formatted outside of the lock, so workers only
+            // serialize on the (short) write
+            std::stringstream row;
+            row << i << ',' << p.wrap_radius << ',' << p.wrap_translation[0] << ',' << p.wrap_translation[1] << ','
+                << p.max_isometric_force << ',' << p.step_start << ',' << p.step_end << ','
+                << r.peak_fiber_force << ',' << r.final_elbow_angle << ',' << r.wall_ms << ',' << w << ','
+                << r.error << '\n';
+
+            std::lock_guard lock{out_mutex};
+            out << row.str();
+            out.flush();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned w = 1; w < num_workers; ++w) {
+        threads.emplace_back(worker, w);
+    }
+    if (num_workers > 0) {
+        worker(0);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    double total_busy_ms = 0;
+    for (double ms : busy_ms) {
+        total_busy_ms += ms;
+    }
+
+    // utilisation: the average number of workers that were running a case,
+    // i.e. summed per-case time over wall time. It isn't a speedup: cases
+    // run concurrently contend for cores and memory, so they each take
+    // longer than they would on their own, and no serial run is timed.
+    double busy_workers = wall_ms > 0 ? total_busy_ms / wall_ms : 0.0;
+    std::stringstream summary;
+    summary << std::fixed
+            << "sweep: " << cases.size() << " cases (" << num_failed.load() << " failed) in "
+            << std::setprecision(1) << wall_ms / 1000.0 << " s, "
+            << std::setprecision(2) << (wall_ms > 0 ? 1000.0 * cases.size() / wall_ms : 0.0) << " cases/s, "
+            << scheduler.steals() << " steals, "
+            << busy_workers << " of " << num_workers << " threads busy on average ("
+            << std::setprecision(0) << (num_workers > 0 ? 100.0 * busy_workers / num_workers : 0.0) << "% utilisation)";
+    std::cerr << summary.str() << std::endl;
+
+    return num_failed == 0 ? 0 : 1;
+}
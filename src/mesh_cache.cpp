@@ -0,0 +1,375 @@
+#include "mesh_cache.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::literals::string_literals::operator""s;
+
+namespace {
+    constexpr char cache_magic[8] = {'O', 'S', 'M', 'E', 'S', 'H', '\0', '\0'};
+    constexpr std::uint32_t cache_version = 2;
+
+    // Header at the start of every cache file. Followed by the (absolute,
+    // UTF-8) source path, then the vertex array, then the index array. Array
+    // offsets are 8-byte aligned. `payload_hash` is the FNV-1a hash of the
+    // vertex array followed by the index array.
+    struct Cache_header final {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t index_size;  // 2 or 4
+        std::int64_t source_mtime;
+        std::uint64_t source_size;
+        std::uint64_t content_hash;
+        std::uint64_t path_len;
+        std::uint64_t num_vertices;
+        std::uint64_t vertices_offset;
+        std::uint64_t num_indices;
+        std::uint64_t indices_offset;
+        std::uint64_t payload_hash;
+    };
+    static_assert(sizeof(Cache_header) % 8 == 0);
+
+    std::uint64_t fnv1a(void const* data, std::size_t n, std::uint64_t hash = 14695981039346656037ULL) {
+        auto const* bytes = static_cast<unsigned char const*>(data);
+        for (std::size_t i = 0; i < n; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // true if `count` elements of `elem_size` bytes, starting at `offset`,
+    // are within a file of `size` bytes (without overflowing)
+    bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem_size, std::uint64_t size) {
+        return offset <= size and count <= (size - offset) / elem_size;
+    }
+
+    std::uint64_t payload_hash(osim::Mesh_data const& data) {
+        std::uint64_t hash = fnv1a(data.vertices.data(), data.vertices.size_bytes());
+        return std::visit([&](auto const& is) { return fnv1a(is.data(), is.size_bytes(), hash); }, data.indices);
+    }
+
+    std::uint64_t align8(std::uint64_t n) {
+        return (n + 7) & ~static_cast<std::uint64_t>(7);
+    }
+
+    std::string to_utf8(std::filesystem::path const& p) {
+        auto s = p.u8string();
+        return std::string{s.begin(), s.end()};
+    }
+
+    // A cache file is named after the source path it caches
+    std::filesystem::path cache_path(std::filesystem::path const& source) {
+        std::string s = to_utf8(source);
+        std::stringstream name;
+        name << std::hex << fnv1a(s.data(), s.size()) << ".mesh";
+        return osim::disk_cache_dir() / name.str();
+    }
+}
+
+#ifdef _WIN32
+osim::Mapped_file::Mapped_file(std::filesystem::path const& path) {
+    file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error{path.string() + ": CreateFileW failed"};
+    }
+
+    LARGE_INTEGER file_size;
+    if (not GetFileSizeEx(file_handle, &file_size)) {
+        CloseHandle(file_handle);
+        throw std::runtime_error{path.string() + ": GetFileSizeEx failed"};
+    }
+    len = static_cast<std::size_t>(file_size.QuadPart);
+    if (len == 0) {
+        return;
+    }
+
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        CloseHandle(file_handle);
+        throw std::runtime_error{path.string() + ": CreateFileMappingW failed"};
+    }
+
+    ptr = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr) {
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        throw std::runtime_error{path.string() + ": MapViewOfFile failed"};
+    }
+}
+
+osim::Mapped_file::~Mapped_file() noexcept {
+    if (ptr != nullptr) {
+        UnmapViewOfFile(ptr);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+    }
+    CloseHandle(file_handle);
+}
+#else
+osim::Mapped_file::Mapped_file(std::filesystem::path const& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error{path.string() + ": open failed: "s + std::strerror(errno)};
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error{path.string() + ": fstat failed: "s + std::strerror(errno)};
+    }
+    len = static_cast<std::size_t>(st.st_size);
+
+    if (len > 0) {
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error{path.string() + ": mmap failed: "s + std::strerror(errno)};
+        }
+        ptr = p;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+osim::Mapped_file::~Mapped_file() noexcept {
+    if (ptr != nullptr) {
+        munmap(const_cast<void*>(ptr), len);
+    }
+}
+#endif
+
+std::filesystem::path osim::unique_temp_path(std::filesystem::path const& dest) {
+    // the pid separates processes, the counter separates threads (and
+    // calls), and the random part guards against pid reuse
+#ifdef _WIN32
+    auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    auto pid = static_cast<unsigned long>(getpid());
+#endif
+    static std::atomic<std::uint64_t> counter{0};
+    static std::uint64_t const salt = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+
+    std::stringstream suffix;
+    suffix << '.' << pid << '-' << std::hex << (salt ^ counter.fetch_add(1)) << ".tmp";
+    std::filesystem::path rv = dest;
+    rv += suffix.str();
+    return rv;
+}
+
+std::optional<std::uint64_t> osim::hash_file(std::filesystem::path const& path) {
+    std::ifstream f{path, std::ios::binary};
+    if (not f) {
+        return std::nullopt;
+    }
+
+    std::uint64_t hash = 14695981039346656037ULL;
+    char buf[1<<16];
+    while (f.read(buf, sizeof(buf)) or f.gcount() > 0) {
+        hash = fnv1a(buf, static_cast<std::size_t>(f.gcount()), hash);
+    }
+    return hash;
+}
+
+std::optional<osim::Mesh_source> osim::mesh_source(std::filesystem::path const& path) {
+    std::error_code ec;
+    std::filesystem::path abs = std::filesystem::absolute(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    auto mtime = std::filesystem::last_write_time(abs, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    auto size = std::filesystem::file_size(abs, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    return Mesh_source{
+        .path = std::move(abs),
+        .mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count()),
+        .size = static_cast<std::uint64_t>(size),
+    };
+}
+
+std::optional<osim::Disk_cached_mesh> osim::disk_cache_load(Mesh_source const& source) {
+    std::filesystem::path p = cache_path(source.path);
+
+    std::error_code ec;
+    if (not std::filesystem::exists(p, ec)) {
+        return std::nullopt;
+    }
+
+    std::shared_ptr<Mapped_file> file;
+    try {
+        file = std::make_shared<Mapped_file>(p);
+    } catch (std::exception const&) {
+        return std::nullopt;
+    }
+
+    // validate the header + layout before trusting any offsets in it
+    if (file->size() < sizeof(Cache_header)) {
+        return std::nullopt;
+    }
+    Cache_header h;
+    std::memcpy(&h, file->data(), sizeof(h));
+
+    if (std::memcmp(h.magic, cache_magic, sizeof(cache_magic)) != 0 or h.version != cache_version) {
+        return std::nullopt;
+    }
+    if (h.index_size != 2 and h.index_size != 4) {
+        return std::nullopt;
+    }
+    // every offset and count is checked against the file's size without
+    // overflowing, because a corrupt header can hold any values
+    std::uint64_t size = file->size();
+    if (not fits(sizeof(Cache_header), h.path_len, 1, size)
+        or not fits(h.vertices_offset, h.num_vertices, sizeof(Mesh_vertex), size)
+        or not fits(h.indices_offset, h.num_indices, h.index_size, size)
+        or h.vertices_offset % 8 != 0
+        or h.indices_offset % 8 != 0) {
+        return std::nullopt;
+    }
+
+    // the cache file is named by a hash of the source path, so check that it
+    // really is for this source
+    std::string cached_path{reinterpret_cast<char const*>(file->data() + sizeof(Cache_header)), h.path_len};
+    if (cached_path != to_utf8(source.path)) {
+        return std::nullopt;
+    }
+
+    // fast path: source unchanged. Slow path: source touched (e.g. by a git
+    // checkout) but its content is unchanged
+    if (h.source_mtime != source.mtime or h.source_size != source.size) {
+        if (h.source_size != source.size or hash_file(source.path) != h.content_hash) {
+            return std::nullopt;
+        }
+    }
+
+    Mesh_data data;
+    data.vertices = std::span<Mesh_vertex const>{
+        reinterpret_cast<Mesh_vertex const*>(file->data() + h.vertices_offset),
+        static_cast<std::size_t>(h.num_vertices)
+    };
+    if (h.index_size == 2) {
+        data.indices = std::span<std::uint16_t const>{
+            reinterpret_cast<std::uint16_t const*>(file->data() + h.indices_offset),
+            static_cast<std::size_t>(h.num_indices)
+        };
+    } else {
+        data.indices = std::span<std::uint32_t const>{
+            reinterpret_cast<std::uint32_t const*>(file->data() + h.indices_offset),
+            static_cast<std::size_t>(h.num_indices)
+        };
+    }
+
+    // catches entries that were truncated or corrupted after being written
+    if (payload_hash(data) != h.payload_hash) {
+        return std::nullopt;
+    }
+    data.storage = std::move(file);
+
+    return Disk_cached_mesh{h.content_hash, std::move(data)};
+}
+
+void osim::disk_cache_store(Mesh_source const& source, std::uint64_t content_hash, Mesh_data const& data) {
+    std::string path_str = to_utf8(source.path);
+    std::uint32_t index_size = std::visit([](auto const& is) {
+        return static_cast<std::uint32_t>(sizeof(typename std::decay_t<decltype(is)>::element_type));
+    }, data.indices);
+    std::size_t num_indices = std::visit([](auto const& is) { return is.size(); }, data.indices);
+
+    Cache_header h{};
+    std::memcpy(h.magic, cache_magic, sizeof(cache_magic));
+    h.version = cache_version;
+    h.index_size = index_size;
+    h.source_mtime = source.mtime;
+    h.source_size = source.size;
+    h.content_hash = content_hash;
+    h.path_len = path_str.size();
+    h.num_vertices = data.vertices.size();
+    h.vertices_offset = align8(sizeof(Cache_header) + h.path_len);
+    h.num_indices = num_indices;
+    h.indices_offset = align8(h.vertices_offset + h.num_vertices * sizeof(Mesh_vertex));
+    h.payload_hash = payload_hash(data);
+
+    std::filesystem::path dest = cache_path(source.path);
+    // each writer has its own temp file, so concurrent stores of the same
+    // entry (e.g. by `warm_cache` and `show`) can't interleave their writes
+    std::filesystem::path tmp = osim::unique_temp_path(dest);
+
+    try {
+        std::filesystem::create_directories(dest.parent_path());
+
+        {
+            std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+            if (not out) {
+                throw std::runtime_error{tmp.string() + ": cannot open for writing"};
+            }
+
+            static constexpr char zeroes[8] = {};
+            auto pad_to = [&](std::uint64_t offset) {
+                auto pos = static_cast<std::uint64_t>(out.tellp());
+                out.write(zeroes, static_cast<std::streamsize>(offset - pos));
+            };
+
+            out.write(reinterpret_cast<char const*>(&h), sizeof(h));
+            out.write(path_str.data(), static_cast<std::streamsize>(path_str.size()));
+            pad_to(h.vertices_offset);
+            out.write(reinterpret_cast<char const*>(data.vertices.data()),
+                      static_cast<std::streamsize>(data.vertices.size_bytes()));
+            pad_to(h.indices_offset);
+            std::visit([&](auto const& is) {
+                out.write(reinterpret_cast<char const*>(is.data()), static_cast<std::streamsize>(is.size_bytes()));
+            }, data.indices);
+
+            if (not out) {
+                throw std::runtime_error{tmp.string() + ": write failed"};
+            }
+        }
+
+        // rename is atomic, so concurrent readers never see a partial file
+        std::filesystem::rename(tmp, dest);
+    } catch (std::exception const& ex) {
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+        std::cerr << "mesh cache: could not write entry for " << path_str << ": " << ex.what() << std::endl;
+    }
+}
+
+std::filesystem::path osim::disk_cache_dir() {
+    if (char const* dir = std::getenv("OSIM_SNIPPETS_MESH_CACHE"); dir != nullptr and *dir != '\0') {
+        return std::filesystem::path{dir};
+    }
+#ifndef _WIN32
+    if (char const* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr and *xdg != '\0') {
+        return std::filesystem::path{xdg} / "osim-snippets" / "meshes";
+    }
+    if (char const* home = std::getenv("HOME"); home != nullptr and *home != '\0') {
+        return std::filesystem::path{home} / ".cache" / "osim-snippets" / "meshes";
+    }
+#endif
+    return std::filesystem::temp_directory_path() / "osim-snippets" / "meshes";
+}
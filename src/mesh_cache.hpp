@@ -0,0 +1,87 @@
+#ifndef MESH_CACHE_HPP
+#define MESH_CACHE_HPP
+
+#include "opensim_wrapper.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+// On-disk cache of triangulated meshes
+//
+// Each source mesh file (e.g. a bone .vtp) gets one cache file, which is a
+// fixed-size header followed by the mesh's (interleaved) vertices and its
+// indices. The arrays are stored exactly as they are uploaded to the GPU, so a
+// cache hit is just an mmap and a checksum pass over it: the mapped arrays are
+// handed straight to glBufferData, with no parsing or copying.
+//
+// Cache files are native-endian and are not meant to be portable between
+// machines.
+namespace osim {
+    // Read-only memory mapping of a whole file
+    class Mapped_file final {
+        void const* ptr = nullptr;
+        std::size_t len = 0;
+#ifdef _WIN32
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#endif
+    public:
+        // throws if the file cannot be opened/mapped
+        Mapped_file(std::filesystem::path const&);
+        Mapped_file(Mapped_file const&) = delete;
+        Mapped_file(Mapped_file&&) = delete;
+        Mapped_file& operator=(Mapped_file const&) = delete;
+        Mapped_file& operator=(Mapped_file&&) = delete;
+        ~Mapped_file() noexcept;
+
+        std::byte const* data() const noexcept {
+            return static_cast<std::byte const*>(ptr);
+        }
+
+        std::size_t size() const noexcept {
+            return len;
+        }
+    };
+
+    // A path, next to `dest`, that no other writer (thread or process) will
+    // use. Files are written there and then renamed to `dest`, so that
+    // readers only ever see complete files.
+    std::filesystem::path unique_temp_path(std::filesystem::path const& dest);
+
+    // 64-bit FNV-1a hash of a file's contents (nullopt if it can't be read)
+    std::optional<std::uint64_t> hash_file(std::filesystem::path const&);
+
+    // Identity of a source mesh file, which is what cache entries are keyed by
+    struct Mesh_source final {
+        std::filesystem::path path;  // absolute
+        std::int64_t mtime;          // std::filesystem::file_time_type::rep
+        std::uint64_t size;
+    };
+
+    // Returns the identity of the file at `path`, or nullopt if it isn't a
+    // readable file
+    std::optional<Mesh_source> mesh_source(std::filesystem::path const& path);
+
+    struct Disk_cached_mesh final {
+        std::uint64_t content_hash;
+        Mesh_data data;  // views into the mapped cache file
+    };
+
+    // Returns the cached mesh for `source` if the disk cache has an entry for
+    // it that is still valid. An entry is valid if the source's mtime and size
+    // are unchanged or, failing that, if the source's content hash is.
+    std::optional<Disk_cached_mesh> disk_cache_load(Mesh_source const& source);
+
+    // Writes `data` to the disk cache as the entry for `source`. Best-effort:
+    // failures are reported on stderr, but are otherwise ignored.
+    void disk_cache_store(Mesh_source const& source, std::uint64_t content_hash, Mesh_data const& data);
+
+    // Directory that cache files are written to. Can be overridden with the
+    // OSIM_SNIPPETS_MESH_CACHE environment variable.
+    std::filesystem::path disk_cache_dir();
+}
+
+#endif // MESH_CACHE_HPP
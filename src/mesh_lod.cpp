@@ -0,0 +1,235 @@
+#include "mesh_lod.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+    // Symmetric 4x4 matrix, Q = [A b; b^T c], that measures the sum of squared
+    // distances from a point to a set of planes: err(p) = p^T A p + 2 b.p + c
+    struct Quadric final {
+        // upper triangle of A, then b, then c
+        std::array<double, 10> q{};
+
+        void add_plane(glm::dvec3 const& n, double d, double weight) {
+            q[0] += weight * n.x * n.x;
+            q[1] += weight * n.x * n.y;
+            q[2] += weight * n.x * n.z;
+            q[3] += weight * n.y * n.y;
+            q[4] += weight * n.y * n.z;
+            q[5] += weight * n.z * n.z;
+            q[6] += weight * n.x * d;
+            q[7] += weight * n.y * d;
+            q[8] += weight * n.z * d;
+            q[9] += weight * d * d;
+        }
+
+        // the point that minimizes the error, if A is well-conditioned
+        bool minimizer(glm::dvec3& out) const {
+            glm::dmat3 a{
+                q[0], q[1], q[2],
+                q[1], q[3], q[4],
+                q[2], q[4], q[5],
+            };
+            double det = glm::determinant(a);
+
+            // scale-independent conditioning test: compare the determinant
+            // with the cube of the trace
+            double trace = q[0] + q[3] + q[5];
+            if (trace <= 0.0 or std::abs(det) < 1e-6 * trace * trace * trace) {
+                return false;  // flat or linear cluster: no unique minimizer
+            }
+            out = -(glm::inverse(a) * glm::dvec3{q[6], q[7], q[8]});
+            return true;
+        }
+    };
+
+    struct Cluster final {
+        Quadric quadric;
+        glm::dvec3 position_sum{0.0};
+        std::size_t num_vertices = 0;
+    };
+
+    template<typename Index>
+    std::vector<Index> to_indices(std::vector<std::uint32_t> const& in) {
+        std::vector<Index> rv;
+        rv.reserve(in.size());
+        for (std::uint32_t i : in) {
+            rv.push_back(static_cast<Index>(i));
+        }
+        return rv;
+    }
+
+    // owns a decimated mesh's arrays (see `osim::Mesh_data::storage`)
+    template<typename Index>
+    struct Lod_buffers final {
+        std::vector<osim::Mesh_vertex> vertices;
+        std::vector<Index> indices;
+    };
+
+    template<typename Index>
+    osim::Mesh_data make_mesh_data(std::vector<osim::Mesh_vertex> vertices, std::vector<std::uint32_t> const& indices) {
+        auto buffers = std::make_shared<Lod_buffers<Index>>();
+        buffers->vertices = std::move(vertices);
+        buffers->indices = to_indices<Index>(indices);
+
+        osim::Mesh_data rv;
+        rv.vertices = buffers->vertices;
+        rv.indices = std::span<Index const>{buffers->indices};
+        rv.storage = std::move(buffers);
+        return rv;
+    }
+
+    std::size_t num_triangles(osim::Mesh_data const& m) {
+        return std::visit([](auto const& is) { return is.size() / 3; }, m.indices);
+    }
+}
+
+osim::Mesh_lod osim::decimate(Mesh_data const& mesh, unsigned resolution) {
+    std::vector<std::uint32_t> in_indices = std::visit([](auto const& is) {
+        return std::vector<std::uint32_t>(is.begin(), is.end());
+    }, mesh.indices);
+
+    if (mesh.vertices.empty() or resolution == 0) {
+        return Mesh_lod{make_mesh_data<std::uint16_t>({}, {}), 0.0f};
+    }
+
+    glm::vec3 min = mesh.vertices.front().position;
+    glm::vec3 max = min;
+    for (Mesh_vertex const& v : mesh.vertices) {
+        min = glm::min(min, v.position);
+        max = glm::max(max, v.position);
+    }
+    glm::vec3 extent = max - min;
+    float cell_size = std::max({extent.x, extent.y, extent.z}) / static_cast<float>(resolution);
+    if (cell_size <= 0.0f) {
+        cell_size = 1.0f;  // degenerate (single point) mesh
+    }
+
+    // bucket each vertex into a grid cell
+    std::unordered_map<std::uint64_t, std::uint32_t> cell_to_cluster;
+    std::vector<Cluster> clusters;
+    std::vector<std::uint32_t> vertex_to_cluster(mesh.vertices.size());
+    for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+        glm::vec3 cell = glm::floor((mesh.vertices[i].position - min) / cell_size);
+        auto x = static_cast<std::uint64_t>(cell.x);
+        auto y = static_cast<std::uint64_t>(cell.y);
+        auto z = static_cast<std::uint64_t>(cell.z);
+        std::uint64_t key = (x << 42) | (y << 21) | z;
+
+        auto [it, inserted] = cell_to_cluster.try_emplace(key, static_cast<std::uint32_t>(clusters.size()));
+        if (inserted) {
+            clusters.emplace_back();
+        }
+        Cluster& c = clusters[it->second];
+        c.position_sum += glm::dvec3{mesh.vertices[i].position};
+        ++c.num_vertices;
+        vertex_to_cluster[i] = it->second;
+    }
+
+    // accumulate each triangle's (area-weighted) plane into the clusters of
+    // its vertices
+    for (std::size_t t = 0; t + 2 < in_indices.size(); t += 3) {
+        glm::dvec3 p0{mesh.vertices[in_indices[t]].position};
+        glm::dvec3 p1{mesh.vertices[in_indices[t+1]].position};
+        glm::dvec3 p2{mesh.vertices[in_indices[t+2]].position};
+        glm::dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+        double len = glm::length(cross);
+        if (len <= 0.0) {
+            continue;
+        }
+        glm::dvec3 n = cross / len;
+        double d = -glm::dot(n, p0);
+        double area = len / 2.0;
+        for (int v = 0; v < 3; ++v) {
+            clusters[vertex_to_cluster[in_indices[t+v]]].quadric.add_plane(n, d, area);
+        }
+    }
+
+    // place each cluster's representative vertex. The quadric minimizer is
+    // only trusted if it stays near its cell, otherwise (e.g. for nearly
+    // parallel planes) the vertices' centroid is used
+    std::vector<Mesh_vertex> out_vertices(clusters.size());
+    for (std::size_t i = 0; i < clusters.size(); ++i) {
+        Cluster const& c = clusters[i];
+        glm::dvec3 centroid = c.position_sum / static_cast<double>(c.num_vertices);
+        glm::dvec3 p;
+        if (not c.quadric.minimizer(p) or glm::length(p - centroid) > 2.0 * cell_size) {
+            p = centroid;
+        }
+        out_vertices[i].position = glm::vec3{p};
+        out_vertices[i].normal = {0.0f, 0.0f, 0.0f};
+    }
+
+    // keep only triangles whose vertices ended up in 3 distinct clusters
+    std::vector<std::uint32_t> out_indices;
+    for (std::size_t t = 0; t + 2 < in_indices.size(); t += 3) {
+        std::uint32_t a = vertex_to_cluster[in_indices[t]];
+        std::uint32_t b = vertex_to_cluster[in_indices[t+1]];
+        std::uint32_t c = vertex_to_cluster[in_indices[t+2]];
+        if (a == b or b == c or a == c) {
+            continue;
+        }
+        out_indices.push_back(a);
+        out_indices.push_back(b);
+        out_indices.push_back(c);
+
+        // area-weighted vertex normals
+        glm::vec3 n = glm::cross(out_vertices[b].position - out_vertices[a].position,
+                                 out_vertices[c].position - out_vertices[a].position);
+        out_vertices[a].normal += n;
+        out_vertices[b].normal += n;
+        out_vertices[c].normal += n;
+    }
+    for (Mesh_vertex& v : out_vertices) {
+        float len = glm::length(v.normal);
+        v.normal = len > 0.0f ? v.normal / len : glm::vec3{0.0f, 1.0f, 0.0f};
+    }
+
+    // a vertex can move anywhere within its cell (or slightly outside it, if
+    // the minimizer was used), so the cell diagonal bounds the error
+    float error = std::sqrt(3.0f) * cell_size;
+
+    if (out_vertices.size() <= std::numeric_limits<std::uint16_t>::max()) {
+        return Mesh_lod{make_mesh_data<std::uint16_t>(std::move(out_vertices), out_indices), error};
+    } else {
+        return Mesh_lod{make_mesh_data<std::uint32_t>(std::move(out_vertices), out_indices), error};
+    }
+}
+
+std::vector<osim::Mesh_lod> osim::decimation_chain(Mesh_data const& mesh,
+                                                   std::size_t max_levels,
+                                                   std::size_t min_triangles) {
+    std::vector<Mesh_lod> rv;
+
+    std::size_t prev_triangles = num_triangles(mesh);
+    unsigned resolution = 64;
+    while (rv.size() < max_levels and resolution >= 2) {
+        Mesh_lod lod = decimate(mesh, resolution);
+        std::size_t n = num_triangles(lod.data);
+
+        // not worth a level if it doesn't remove at least a quarter of the
+        // triangles (e.g. the mesh is already coarser than the grid)
+        if (n < min_triangles or n * 4 > prev_triangles * 3) {
+            if (n < min_triangles) {
+                break;
+            }
+            resolution /= 2;
+            continue;
+        }
+
+        prev_triangles = n;
+        rv.push_back(std::move(lod));
+        resolution /= 2;
+    }
+
+    return rv;
+}
@@ -0,0 +1,40 @@
+#ifndef MESH_LOD_HPP
+#define MESH_LOD_HPP
+
+#include "opensim_wrapper.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// Level-of-detail chains for triangle meshes
+//
+// Meshes are simplified by vertex clustering with quadric error metrics
+// (Lindstrom, "Out-of-Core Simplification of Large Polygonal Models", 2000):
+// vertices are bucketed into a uniform grid, and each non-empty cell is
+// replaced by the single point that minimizes the squared distance to the
+// planes of all of the triangles that touch it. Unlike edge collapse, this
+// needs no connectivity information and runs in linear time, so a whole
+// chain can be built while a model loads.
+namespace osim {
+    struct Mesh_lod final {
+        Mesh_data data;
+
+        // upper bound on how far (in mesh-space units) this level's surface
+        // strays from the original mesh
+        float error;
+    };
+
+    // Returns progressively coarser simplifications of `mesh`, excluding
+    // `mesh` itself. Each level uses a grid half as fine as the previous one.
+    // The chain stops early once a level would no longer meaningfully reduce
+    // the triangle count, or would have fewer than `min_triangles` triangles.
+    std::vector<Mesh_lod> decimation_chain(Mesh_data const& mesh,
+                                           std::size_t max_levels = 3,
+                                           std::size_t min_triangles = 32);
+
+    // Simplifies `mesh` by clustering its vertices into a grid that has
+    // `resolution` cells along the mesh's longest axis
+    Mesh_lod decimate(Mesh_data const& mesh, unsigned resolution);
+}
+
+#endif // MESH_LOD_HPP
@@ -6,6 +6,8 @@
 #include <SDL.h>
 #undef main
 #include "opensim_wrapper.hpp"
+#include "mesh_lod.hpp"
+#include "trajectory.hpp"
 #include "OsimsnippetsConfig.h"
 
 #include <GL/glew.h>
@@ -34,6 +36,20 @@
 #include <atomic>
 #include <thread>
 #include <fstream>
+#include <unordered_map>
+#include <memory>
+#include <span>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdio>
+#include <cctype>
+#include <numeric>
+#include <functional>
+#include <utility>
 
 using std::literals::string_literals::operator""s;
 using std::literals::chrono_literals::operator""ms;
@@ -56,7 +72,7 @@ template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 #define OSC_GLSL_VERSION "#version 150"
 #define OSC_GL_CTX_FLAGS 0
 #define OSC_GL_CTX_MAJOR_VERSION 3
-#define OSC_GL_CTX_MINOR_VERSION 0
+#define OSC_GL_CTX_MINOR_VERSION 3  // instanced rendering needs glVertexAttribDivisor (3.3)
 #endif
 
 // macros for quality-of-life checks
@@ -599,6 +615,13 @@ namespace gl {
         glEnableVertexAttribArray(a);
     }
 
+    // Makes the attribute advance once per `divisor` instances, rather than
+    // once per vertex:
+    //     https://www.khronos.org/opengl/wiki/Vertex_Specification#Instanced_arrays
+    void VertexAttribDivisor(Attribute& a, GLuint divisor) {
+        glVertexAttribDivisor(a, divisor);
+    }
+
     class Buffer {
         GLuint handle = static_cast<GLuint>(-1);
     public:
@@ -656,6 +679,170 @@ namespace gl {
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, num_bytes, data, usage);
     }
 
+    // Ring buffer for data that is rewritten every frame (e.g. muscle paths)
+    //
+    // The buffer is split into `num_regions` regions. Each frame writes the
+    // next region while the GPU may still be reading the previous ones. Each
+    // region is fenced (`glFenceSync`) after the draws that read it, and the
+    // fence is waited on before the region is rewritten, so the CPU only
+    // waits if the GPU falls more than `num_regions - 1` frames behind.
+    //
+    // The buffer is persistently mapped if ARB_buffer_storage is available.
+    // Otherwise, it falls back to orphaning: the buffer is re-specified with
+    // glBufferData(nullptr) before each write, which lets the driver hand out
+    // fresh storage rather than synchronizing with in-flight draws.
+    class Stream_buffer final {
+    public:
+        static constexpr int num_regions = 3;
+
+    private:
+        std::optional<Array_buffer> buffer;
+        bool persistent;
+        size_t region_size = 0;  // bytes
+        std::byte* mapped = nullptr;  // whole buffer if persistent, else the current write
+        GLsync fences[num_regions] = {};
+        int region = 0;
+        size_t waits = 0;
+
+        void release() noexcept {
+            for (GLsync& f : fences) {
+                if (f != nullptr) {
+                    glDeleteSync(f);
+                    f = nullptr;
+                }
+            }
+            if (mapped != nullptr and buffer) {
+                glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            }
+            mapped = nullptr;
+            buffer.reset();
+        }
+
+        // (re)allocates the buffer so that each region can hold at least
+        // `min_region_size` bytes. The old buffer may still be in use by the
+        // GPU, but GL defers deleting it until it isn't.
+        void allocate(size_t min_region_size) {
+            release();
+
+            region_size = std::max({min_region_size, 2*region_size, static_cast<size_t>(1<<16)});
+            region_size = (region_size + 255) & ~static_cast<size_t>(255);
+            region = 0;
+
+            buffer.emplace();
+            glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+            if (persistent) {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                GLsizeiptr size = static_cast<GLsizeiptr>(region_size * num_regions);
+                glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+                mapped = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+                if (mapped == nullptr) {
+                    throw std::runtime_error{"glMapBufferRange: failed to persistently map a stream buffer"};
+                }
+            }
+        }
+
+    public:
+        Stream_buffer() : persistent{GLEW_ARB_buffer_storage != 0} {
+            allocate(0);
+        }
+        Stream_buffer(Stream_buffer const&) = delete;
+        Stream_buffer(Stream_buffer&& tmp) noexcept :
+            buffer{std::move(tmp.buffer)},
+            persistent{tmp.persistent},
+            region_size{tmp.region_size},
+            mapped{tmp.mapped},
+            region{tmp.region},
+            waits{tmp.waits} {
+
+            for (int i = 0; i < num_regions; ++i) {
+                fences[i] = tmp.fences[i];
+                tmp.fences[i] = nullptr;
+            }
+            tmp.buffer.reset();
+            tmp.mapped = nullptr;
+        }
+        Stream_buffer& operator=(Stream_buffer const&) = delete;
+        Stream_buffer& operator=(Stream_buffer&&) = delete;
+        ~Stream_buffer() noexcept {
+            release();
+        }
+
+        // Returns `num_bytes` of writable memory in the next region. Must be
+        // followed by `unmap()` before anything draws from the buffer.
+        std::byte* map(size_t num_bytes) {
+            if (num_bytes > region_size) {
+                allocate(num_bytes);
+            }
+
+            if (not persistent) {
+                glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+                glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(region_size), nullptr, GL_STREAM_DRAW);
+                if (num_bytes > 0) {
+                    void* p = glMapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(num_bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                    if (p == nullptr) {
+                        throw std::runtime_error{"glMapBufferRange: failed to map a stream buffer"};
+                    }
+                    mapped = static_cast<std::byte*>(p);
+                }
+                return mapped;
+            }
+
+            region = (region + 1) % num_regions;
+            if (GLsync& f = fences[region]; f != nullptr) {
+                GLenum status = glClientWaitSync(f, 0, 0);
+                if (status == GL_TIMEOUT_EXPIRED) {
+                    // the GPU is still reading this region from a few frames ago
+                    ++waits;
+                    do {
+                        status = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                    } while (status == GL_TIMEOUT_EXPIRED);
+                }
+                glDeleteSync(f);
+                f = nullptr;
+            }
+            return mapped + region*region_size;
+        }
+
+        void unmap() {
+            if (not persistent and mapped != nullptr) {
+                glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+                mapped = nullptr;
+            }
+        }
+
+        // byte offset, within the buffer, of the most recently mapped region
+        size_t offset() const noexcept {
+            return persistent ? region*region_size : 0;
+        }
+
+        // call after issuing the draws that read the most recently mapped
+        // region
+        void fence() {
+            if (not persistent) {
+                return;
+            }
+            if (fences[region] != nullptr) {
+                glDeleteSync(fences[region]);
+            }
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        bool is_persistent() const noexcept {
+            return persistent;
+        }
+
+        // number of times `map` had to wait for the GPU
+        size_t num_waits() const noexcept {
+            return waits;
+        }
+
+        operator GLuint () noexcept {
+            return *buffer;
+        }
+    };
+
     class Vertex_array final {
         GLuint handle = static_cast<GLuint>(-1);
     public:
@@ -670,7 +857,7 @@ namespace gl {
         Vertex_array& operator=(Vertex_array const&) = delete;
         Vertex_array& operator=(Vertex_array&&) = delete;
         ~Vertex_array() noexcept {
-            if (handle == static_cast<GLuint>(-1)) {
+            if (handle != static_cast<GLuint>(-1)) {
                 glDeleteVertexArrays(1, &handle);
             }
         }
@@ -727,6 +914,113 @@ namespace gl {
     void GenerateMipMap(Texture_2d&) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
+
+    struct Pixel_pack_buffer final : public Buffer {
+        Pixel_pack_buffer() : Buffer{GL_PIXEL_PACK_BUFFER} {
+        }
+    };
+
+    void BindBuffer(Pixel_pack_buffer& buffer) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    }
+
+    class Renderbuffer final {
+        GLuint handle = static_cast<GLuint>(-1);
+    public:
+        Renderbuffer() {
+            glGenRenderbuffers(1, &handle);
+        }
+        Renderbuffer(Renderbuffer const&) = delete;
+        Renderbuffer(Renderbuffer&& tmp) : handle{tmp.handle} {
+            tmp.handle = static_cast<GLuint>(-1);
+        }
+        Renderbuffer& operator=(Renderbuffer const&) = delete;
+        Renderbuffer& operator=(Renderbuffer&&) = delete;
+        ~Renderbuffer() noexcept {
+            if (handle != static_cast<GLuint>(-1)) {
+                glDeleteRenderbuffers(1, &handle);
+            }
+        }
+
+        operator GLuint () noexcept {
+            return handle;
+        }
+    };
+
+    // allocates storage for `rb`, which is multisampled if `samples > 1`
+    void RenderbufferStorage(Renderbuffer& rb, GLsizei samples, GLenum format, GLsizei w, GLsizei h) {
+        glBindRenderbuffer(GL_RENDERBUFFER, rb);
+        if (samples > 1) {
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, w, h);
+        } else {
+            glRenderbufferStorage(GL_RENDERBUFFER, format, w, h);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    class Framebuffer final {
+        GLuint handle = static_cast<GLuint>(-1);
+    public:
+        Framebuffer() {
+            glGenFramebuffers(1, &handle);
+        }
+        Framebuffer(Framebuffer const&) = delete;
+        Framebuffer(Framebuffer&& tmp) : handle{tmp.handle} {
+            tmp.handle = static_cast<GLuint>(-1);
+        }
+        Framebuffer& operator=(Framebuffer const&) = delete;
+        Framebuffer& operator=(Framebuffer&&) = delete;
+        ~Framebuffer() noexcept {
+            if (handle != static_cast<GLuint>(-1)) {
+                glDeleteFramebuffers(1, &handle);
+            }
+        }
+
+        operator GLuint () noexcept {
+            return handle;
+        }
+    };
+
+    void BindFramebuffer(GLenum target, Framebuffer& fbo) {
+        glBindFramebuffer(target, fbo);
+    }
+
+    // binds the window's (default) framebuffer
+    void BindFramebuffer() {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    class Query final {
+        GLuint handle = static_cast<GLuint>(-1);
+    public:
+        Query() {
+            glGenQueries(1, &handle);
+        }
+        Query(Query const&) = delete;
+        Query(Query&& tmp) : handle{tmp.handle} {
+            tmp.handle = static_cast<GLuint>(-1);
+        }
+        Query& operator=(Query const&) = delete;
+        Query& operator=(Query&&) = delete;
+        ~Query() noexcept {
+            if (handle != static_cast<GLuint>(-1)) {
+                glDeleteQueries(1, &handle);
+            }
+        }
+
+        operator GLuint () noexcept {
+            return handle;
+        }
+    };
+
+    void assert_framebuffer_complete(GLenum target, char const* what) {
+        GLenum status = glCheckFramebufferStatus(target);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::stringstream ss;
+            ss << what << ": framebuffer incomplete (status = 0x" << std::hex << status << ")";
+            throw std::runtime_error{ss.str()};
+        }
+    }
 }
 
 namespace glglm {
@@ -870,7 +1164,9 @@ namespace  osim {
           << "    transform = " << m.transform << std::endl
           << "    scale = " << m.scale << std::endl
           << "    rgba = " << m.rgba << std::endl
-          << "    num_triangles = " << m.triangles.size() << std::endl;
+          << "    mesh_id = " << m.mesh_id << std::endl
+          << "    num_vertices = " << m.data->vertices.size() << std::endl
+          << "    num_triangles = " << std::visit([](auto const& is) { return is.size()/3; }, m.data->indices) << std::endl;
         return o;
     }
     std::ostream& operator<<(std::ostream& o, osim::Geometry const& g) {
@@ -880,14 +1176,35 @@ namespace  osim {
 }
 
 namespace ui {
-    sdl::Window init_gl_window(sdl::Context&) {
-        OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_CONTEXT_FLAGS, OSC_GL_CTX_FLAGS);
+    void set_gl_context_attributes() {
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_CONTEXT_FLAGS, OSC_GL_CTX_FLAGS);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_CONTEXT_MAJOR_VERSION, OSC_GL_CTX_MAJOR_VERSION);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_CONTEXT_MINOR_VERSION, OSC_GL_CTX_MINOR_VERSION);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_DEPTH_SIZE, 24);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_STENCIL_SIZE, 8);
+    }
+
+    // initializes GLEW against the current context. `headless` tolerates
+    // GLEW_ERROR_NO_GLX_DISPLAY, which a GLX-built GLEW reports for EGL
+    // contexts *after* it has successfully loaded the GL entry points.
+    void init_glew(bool headless) {
+        if (auto err = glewInit(); err != GLEW_OK and not (headless and err == GLEW_ERROR_NO_GLX_DISPLAY)) {
+            std::stringstream ss;
+            ss << "glewInit() failed: ";
+            ss << glewGetErrorString(err);
+            throw std::runtime_error{ss.str()};
+        }
+
+        DEBUG_PRINT("OpenGL info: %s: %s (%s) /w GLSL: %s\n",
+                    glGetString(GL_VENDOR),
+                    glGetString(GL_RENDERER),
+                    glGetString(GL_VERSION),
+                    glGetString(GL_SHADING_LANGUAGE_VERSION));
+    }
+
+    sdl::Window init_gl_window(sdl::Context&) {
+        set_gl_context_attributes();
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_MULTISAMPLEBUFFERS, 1);
         OSC_SDL_GL_SetAttribute_CHECK(SDL_GL_MULTISAMPLESAMPLES, 16);
 
@@ -915,22 +1232,56 @@ namespace ui {
             }
 
             // initialize GLEW, which is what imgui is using under the hood
-            if (auto err = glewInit(); err != GLEW_OK) {
-                std::stringstream ss;
-                ss << "glewInit() failed: ";
-                ss << glewGetErrorString(err);
-                throw std::runtime_error{ss.str()};
-            }
-
-            DEBUG_PRINT("OpenGL info: %s: %s (%s) /w GLSL: %s\n",
-                        glGetString(GL_VENDOR),
-                        glGetString(GL_RENDERER),
-                        glGetString(GL_VERSION),
-                        glGetString(GL_SHADING_LANGUAGE_VERSION));
+            init_glew(false);
 
             gl::assert_no_errors("ui::State::constructor::onExit");
         }
     };
+
+    // SDL's "offscreen" video driver creates EGL pbuffer-backed windows, so
+    // it needs no display server (and, with Mesa's llvmpipe, no GPU). It can
+    // be overridden with the usual SDL_VIDEODRIVER environment variable.
+    //
+    // SDL only builds the driver when configured with VIDEO_OFFSCREEN, which
+    // the top-level CMakeLists.txt turns on for the vendored SDL.
+    sdl::Context init_headless_sdl() {
+        SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+        return sdl::Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    }
+
+    sdl::Window init_headless_gl_window(sdl::Context&) {
+        set_gl_context_attributes();
+
+        // frames are rendered into FBOs, so the window's framebuffer is never
+        // drawn to (and doesn't need to be multisampled)
+        return sdl::CreateWindoww(
+            "Model Renderer v" OSIMSNIPPETS_VERSION_STRING,
+            SDL_WINDOWPOS_UNDEFINED,
+            SDL_WINDOWPOS_UNDEFINED,
+            16,
+            16,
+            SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    }
+
+    // Like `State`, but for rendering without a visible window (see
+    // `init_headless_sdl`)
+    struct Headless_state final {
+        sdl::Context context = init_headless_sdl();
+        sdl::Window window = init_headless_gl_window(context);
+        sdl::GLContext gl = sdl::GL_CreateContext(window);
+
+        Headless_state() {
+            if (SDL_GL_MakeCurrent(window, gl) != 0) {
+                throw std::runtime_error{"SDL_GL_MakeCurrent failed: "s  + SDL_GetError()};
+            }
+            init_glew(true);
+
+            // glewInit can leave a (harmless) GL_INVALID_ENUM behind in core
+            // profiles, so clear it rather than asserting on it
+            while (glGetError() != GL_NO_ERROR) {
+            }
+        }
+    };
 }
 
 namespace examples::imgui {
@@ -1003,6 +1354,79 @@ namespace examples::imgui {
         }
     )";
 
+    static const char instanced_vertex_shader_src[] = OSC_GLSL_VERSION R"(
+        // Same Gouraud shader as above, but the model matrix and color are
+        // per-instance attributes, so that many copies of one mesh (e.g. all
+        // spheres in the scene) can be drawn with one glDrawArraysInstanced
+
+        uniform mat4 projMat;
+        uniform mat4 viewMat;
+
+        uniform vec3 lightPos;
+        uniform vec3 lightColor;
+        uniform vec3 viewPos;
+
+        in vec3 location;
+        in vec3 in_normal;
+        in mat4 instance_modelMat;
+        in vec4 instance_rgba;
+
+        out vec4 frag_color;
+
+        void main() {
+            gl_Position = projMat * viewMat * instance_modelMat * vec4(location, 1.0f);
+            vec3 normal = in_normal;
+            vec3 frag_pos = vec3(instance_modelMat * vec4(location, 1.0f));
+
+            vec3 norm = normalize(normal);
+            vec3 light_dir = normalize(lightPos - frag_pos);
+
+            float diffuse_strength = 0.3f;
+            float diff = max(dot(norm, light_dir), 0.0);
+            vec3 diffuse = diffuse_strength * diff * lightColor;
+
+            float ambient_strength = 0.5f;
+            vec3 ambient = ambient_strength * lightColor;
+
+            float specularStrength = 0.1f;
+            vec3 lightDir = normalize(lightPos - frag_pos);
+            vec3 viewDir = normalize(viewPos - frag_pos);
+            vec3 halfwayDir = normalize(lightDir + viewDir);
+            float spec = pow(max(dot(normal, halfwayDir), 0.0), 32);
+            vec3 specular = specularStrength * spec * lightColor;
+
+            vec3 rgb = (ambient + diffuse + specular) * instance_rgba.rgb;
+            frag_color = vec4(rgb, instance_rgba.a);
+        }
+    )";
+
+    static const char upscale_vertex_shader_src[] = OSC_GLSL_VERSION R"(
+        // fullscreen triangle, generated from the vertex ID (so it needs no
+        // vertex data). It covers the clip-space square, with texture coords
+        // that are [0, 1] over that square.
+
+        out vec2 tex_coord;
+
+        void main() {
+            vec2 p = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+            tex_coord = p;
+            gl_Position = vec4(2.0f * p - 1.0f, 0.0f, 1.0f);
+        }
+    )";
+
+    static const char upscale_frag_shader_src[] = OSC_GLSL_VERSION R"(
+        // samples the (bilinearly-filtered) low-resolution scene
+
+        uniform sampler2D scene;
+
+        in vec2 tex_coord;
+        out vec4 color;
+
+        void main() {
+            color = texture(scene, tex_coord);
+        }
+    )";
+
     // Vector of 3 floats with no padding, so that it can be passed to OpenGL
     struct Vec3 {
         GLfloat x;
@@ -1014,75 +1438,110 @@ namespace examples::imgui {
         Vec3 position;
         Vec3 normal;
     };
+    static_assert(sizeof(Mesh_point) == sizeof(osim::Mesh_vertex));
+    static_assert(offsetof(Mesh_point, normal) == offsetof(osim::Mesh_vertex, normal));
 
     // Returns triangles of a "unit" (radius = 1.0f, origin = 0,0,0) sphere
-    std::vector<Mesh_point> unit_sphere_triangles() {
-        // this is a shitty alg that produces a shitty UV sphere. I don't have
-        // enough time to implement something better, like an isosphere, or
-        // something like a patched sphere:
-        //
-        // https://www.iquilezles.org/www/articles/patchedsphere/patchedsphere.htm
-        //
-        // This one is adapted from:
-        //    http://www.songho.ca/opengl/gl_sphere.html#example_cubesphere
-
-        size_t sectors = 32;
-        size_t stacks = 16;
-
-        // polar coords, with [0, 0, -1] pointing towards the screen with polar
-        // coords theta = 0, phi = 0. The coordinate [0, 1, 0] is theta = (any)
-        // phi = PI/2. The coordinate [1, 0, 0] is theta = PI/2, phi = 0
-        std::vector<Mesh_point> points;
-
-        float theta_step = 2.0f*pi_f / sectors;
-        float phi_step = pi_f / stacks;
-
-        for (size_t stack = 0; stack <= stacks; ++stack) {
-            float phi = pi_f/2.0f - static_cast<float>(stack)*phi_step;
-            float y = sin(phi);
-
-            for (unsigned sector = 0; sector <= sectors; ++sector) {
-                float theta = sector * theta_step;
-                float x = sin(theta) * cos(phi);
-                float z = -cos(theta) * cos(phi);
-                points.push_back(Mesh_point{
-                    .position = {x, y, z},
-                    .normal = {x, y, z},  // sphere is at the origin, so nothing fancy needed
-                });
+    //
+    // The sphere is an icosahedron whose faces have each been split into 4
+    // (with the new vertices pushed out onto the sphere) `subdivisions`
+    // times, so it has 20 * 4^subdivisions triangles. Unlike a UV sphere, the
+    // triangles are all roughly the same size, so every subdivision level is
+    // an evenly-spread LOD for the next.
+    std::vector<Mesh_point> icosphere_triangles(unsigned subdivisions) {
+        float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+        glm::vec3 const icosahedron_verts[12] = {
+            {-1.0f,  t,  0.0f}, { 1.0f,  t,  0.0f}, {-1.0f, -t,  0.0f}, { 1.0f, -t,  0.0f},
+            { 0.0f, -1.0f,  t}, { 0.0f,  1.0f,  t}, { 0.0f, -1.0f, -t}, { 0.0f,  1.0f, -t},
+            {  t,  0.0f, -1.0f}, {  t,  0.0f,  1.0f}, { -t,  0.0f, -1.0f}, { -t,  0.0f,  1.0f},
+        };
+        unsigned const icosahedron_faces[20][3] = {
+            {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+            {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+            {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+            {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1},
+        };
+
+        std::vector<glm::vec3> tris;
+        for (auto const& f : icosahedron_faces) {
+            for (unsigned i : f) {
+                tris.push_back(glm::normalize(icosahedron_verts[i]));
             }
         }
 
-        // the points are not triangles. They are *points of a triangle*, so the
-        // points must be triangulated
-        std::vector<Mesh_point> triangles;
-
-        for (size_t stack = 0; stack < stacks; ++stack) {
-            size_t k1 = stack * (sectors + 1);
-            size_t k2 = k1 + sectors + 1;
-
-            for (size_t sector = 0; sector < sectors; ++sector, ++k1, ++k2) {
-                // 2 triangles per sector - excluding the first and last stacks
-                // (which contain one triangle, at the poles)
-                Mesh_point p1 = points.at(k1);
-                Mesh_point p2 = points.at(k2);
-                Mesh_point p1_plus1 = points.at(k1+1u);
-                Mesh_point p2_plus1 = points.at(k2+1u);
-
-                if (stack != 0) {
-                    triangles.push_back(p1);
-                    triangles.push_back(p2);
-                    triangles.push_back(p1_plus1);
+        for (unsigned level = 0; level < subdivisions; ++level) {
+            std::vector<glm::vec3> subdivided;
+            subdivided.reserve(4 * tris.size());
+            for (size_t i = 0; i < tris.size(); i += 3) {
+                glm::vec3 a = tris[i];
+                glm::vec3 b = tris[i+1];
+                glm::vec3 c = tris[i+2];
+                glm::vec3 ab = glm::normalize(a + b);
+                glm::vec3 bc = glm::normalize(b + c);
+                glm::vec3 ca = glm::normalize(c + a);
+                for (glm::vec3 const& v : {a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca}) {
+                    subdivided.push_back(v);
                 }
+            }
+            tris = std::move(subdivided);
+        }
+
+        std::vector<Mesh_point> rv;
+        rv.reserve(tris.size());
+        for (size_t i = 0; i < tris.size(); i += 3) {
+            // ensure counter-clockwise (outward-facing) winding
+            glm::vec3 a = tris[i];
+            glm::vec3 b = tris[i+1];
+            glm::vec3 c = tris[i+2];
+            if (glm::dot(glm::cross(b - a, c - a), a) < 0.0f) {
+                std::swap(b, c);
+            }
+            for (glm::vec3 const& v : {a, b, c}) {
+                // sphere is at the origin, so the normal is the position
+                rv.push_back(Mesh_point{.position = {v.x, v.y, v.z}, .normal = {v.x, v.y, v.z}});
+            }
+        }
+        return rv;
+    }
 
-                if (stack != (stacks-1)) {
-                    triangles.push_back(p1_plus1);
-                    triangles.push_back(p2);
-                    triangles.push_back(p2_plus1);
+    // Returns triangles of a cube that spans [-1, 1] on each axis, with
+    // per-face normals
+    std::vector<Mesh_point> unit_cube_triangles() {
+        std::vector<Mesh_point> rv;
+        rv.reserve(36);
+        for (int axis = 0; axis < 3; ++axis) {
+            for (float sign : {-1.0f, 1.0f}) {
+                glm::vec3 n{0.0f, 0.0f, 0.0f};
+                n[axis] = sign;
+                glm::vec3 u{0.0f, 0.0f, 0.0f};
+                u[(axis + 1) % 3] = 1.0f;
+                glm::vec3 v = glm::cross(n, u);
+
+                glm::vec3 corners[4] = {n - u - v, n + u - v, n + u + v, n - u + v};
+                for (int i : {0, 1, 2, 0, 2, 3}) {
+                    rv.push_back(Mesh_point{
+                        .position = {corners[i].x, corners[i].y, corners[i].z},
+                        .normal = {n.x, n.y, n.z},
+                    });
                 }
             }
         }
+        return rv;
+    }
 
-        return triangles;
+    // Returns how far the (flat) triangles of a unit sphere mesh stray inside
+    // the true sphere: 1 - (the smallest distance from the origin to a
+    // triangle's plane)
+    float unit_sphere_error(std::vector<Mesh_point> const& tris) {
+        float min_dist = 1.0f;
+        for (size_t i = 0; i + 2 < tris.size(); i += 3) {
+            glm::vec3 a{tris[i].position.x, tris[i].position.y, tris[i].position.z};
+            glm::vec3 b{tris[i+1].position.x, tris[i+1].position.y, tris[i+1].position.z};
+            glm::vec3 c{tris[i+2].position.x, tris[i+2].position.y, tris[i+2].position.z};
+            glm::vec3 n = glm::normalize(glm::cross(b - a, c - a));
+            min_dist = std::min(min_dist, std::abs(glm::dot(n, a)));
+        }
+        return 1.0f - min_dist;
     }
 
     // Returns triangles for a "unit" cylinder with `num_sides` sides.
@@ -1316,185 +1775,3692 @@ namespace examples::imgui {
         return rv;
     }
 
+    // GL type enum for an index type
+    template<typename Index>
+    constexpr GLenum index_type_enum() {
+        static_assert(std::is_same_v<Index, GLushort> or std::is_same_v<Index, GLuint>);
+        return std::is_same_v<Index, GLushort> ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    // A mesh's vertex + index buffers, without a VAO. Buffers are shared
+    // between GL contexts, but VAOs are not, so this is what a background
+    // context can upload (see `Upload_worker`).
+    struct Mesh_buffers {
+        GLsizei num_verts = 0;
+        GLsizei num_indices = 0;
+        GLenum index_type = GL_UNSIGNED_INT;
+        gl::Array_buffer vbo;
+        gl::Element_array_buffer ebo;
+    };
+
+    // uploads `data` into new buffers. Works in any context: no VAO needs to
+    // be bound, because GL_COPY_WRITE_BUFFER is used as the upload target.
+    Mesh_buffers upload_buffers(osim::Mesh_data const& data) {
+        Mesh_buffers rv;
+        rv.num_verts = static_cast<GLsizei>(data.vertices.size());
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, rv.vbo);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(data.vertices.size_bytes()), data.vertices.data(), GL_STATIC_DRAW);
+
+        std::visit([&](auto const& indices) {
+            using Index = typename std::decay_t<decltype(indices)>::value_type;
+            rv.num_indices = static_cast<GLsizei>(indices.size());
+            rv.index_type = index_type_enum<Index>();
+            glBindBuffer(GL_COPY_WRITE_BUFFER, rv.ebo);
+            glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indices.size_bytes()), indices.data(), GL_STATIC_DRAW);
+        }, data.indices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        return rv;
+    }
+
+    size_t size_bytes(osim::Mesh_data const& data) {
+        return data.vertices.size_bytes() + std::visit([](auto const& is) { return is.size_bytes(); }, data.indices);
+    }
+
     // Basic mesh composed of triangles with normals for all vertices
+    //
+    // The mesh is either a flat list of triangle vertices, or (when
+    // constructed with indices) a deduplicated vertex list + an EBO.
     struct Triangle_mesh {
         GLsizei num_verts;
+        GLsizei num_indices = 0;
+        GLenum index_type = GL_UNSIGNED_INT;
         gl::Array_buffer vbo;
+        gl::Element_array_buffer ebo;
         gl::Vertex_array vao;
 
         Triangle_mesh(gl::Attribute& in_attr,
                       gl::Attribute& normal_attr,
                       std::vector<Mesh_point> const& points) :
-            num_verts(static_cast<GLsizei>(points.size())) {
+            Triangle_mesh{in_attr, normal_attr, points.data(), points.size()} {
+        }
+
+        // `points` must be `n` Mesh_point-layout (position + normal) vertices
+        Triangle_mesh(gl::Attribute& in_attr,
+                      gl::Attribute& normal_attr,
+                      void const* points,
+                      size_t n) :
+            num_verts(static_cast<GLsizei>(n)) {
 
             gl::BindVertexArray(vao);
             {
                 gl::BindBuffer(vbo);
-                gl::BufferData(vbo, sizeof(Mesh_point) * points.size(), points.data(), GL_STATIC_DRAW);
+                gl::BufferData(vbo, sizeof(Mesh_point) * n, points, GL_STATIC_DRAW);
                 gl::VertexAttributePointer(in_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), 0);
                 gl::VertexAttributePointer(normal_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), (void*)sizeof(Vec3));
                 gl::EnableVertexAttribArray(in_attr);
+                gl::EnableVertexAttribArray(normal_attr);
             }
             gl::BindVertexArray();
         }
-    };
 
-    Triangle_mesh gen_cylinder_mesh(gl::Attribute& in_attr,
-                                    gl::Attribute& normal_attr,
-                                    unsigned num_sides) {
-        return Triangle_mesh{
-            in_attr,
-            normal_attr,
-            simbody_cylinder_triangles(num_sides),
-        };
-    }
-
-    Triangle_mesh gen_sphere_mesh(gl::Attribute& in_attr,
-                                  gl::Attribute& normal_attr) {
-        auto points = unit_sphere_triangles();
-        return Triangle_mesh{in_attr, normal_attr, points};
-    }
+        // uploads the arrays as-is (e.g. straight out of a mapped mesh cache
+        // file), because osim::Mesh_vertex has the same layout as Mesh_point
+        template<typename Index>
+        Triangle_mesh(gl::Attribute& in_attr,
+                      gl::Attribute& normal_attr,
+                      std::span<osim::Mesh_vertex const> verts,
+                      std::span<Index const> indices) :
+            Triangle_mesh{in_attr, normal_attr, verts.data(), verts.size()} {
 
-    struct App_static_glstate {
-        gl::Program program;
+            num_indices = static_cast<GLsizei>(indices.size());
+            index_type = index_type_enum<Index>();
 
-        gl::UniformMatrix4fv projMat;
-        gl::UniformMatrix4fv viewMat;
-        gl::UniformMatrix4fv modelMat;
-        gl::UniformVec4f rgba;
-        gl::UniformVec3f light_pos;
-        gl::UniformVec3f light_color;
-        gl::UniformVec3f view_pos;
+            // the EBO binding is part of the VAO's state
+            gl::BindVertexArray(vao);
+            {
+                gl::BindBuffer(ebo);
+                gl::BufferData(ebo, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
+            }
+            gl::BindVertexArray();
+        }
 
-        gl::Attribute location;
-        gl::Attribute in_normal;
+        // builds a VAO over buffers that were uploaded elsewhere (e.g. by
+        // another context)
+        Triangle_mesh(gl::Attribute& in_attr,
+                      gl::Attribute& normal_attr,
+                      Mesh_buffers&& buffers) :
+            num_verts{buffers.num_verts},
+            num_indices{buffers.num_indices},
+            index_type{buffers.index_type},
+            vbo{std::move(buffers.vbo)},
+            ebo{std::move(buffers.ebo)} {
 
-        Triangle_mesh cylinder;
-        Triangle_mesh sphere;
+            gl::BindVertexArray(vao);
+            {
+                gl::BindBuffer(vbo);
+                gl::VertexAttributePointer(in_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), 0);
+                gl::VertexAttributePointer(normal_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), (void*)sizeof(Vec3));
+                gl::EnableVertexAttribArray(in_attr);
+                gl::EnableVertexAttribArray(normal_attr);
+                if (is_indexed()) {
+                    gl::BindBuffer(ebo);
+                }
+            }
+            gl::BindVertexArray();
+        }
+
+        bool is_indexed() const noexcept {
+            return num_indices > 0;
+        }
+
+        size_t num_triangles() const noexcept {
+            return static_cast<size_t>(is_indexed() ? num_indices : num_verts) / 3;
+        }
+
+        // draws the mesh: the caller must have bound `vao`
+        void draw() {
+            if (is_indexed()) {
+                glDrawElements(GL_TRIANGLES, num_indices, index_type, nullptr);
+            } else {
+                glDrawArrays(GL_TRIANGLES, 0, num_verts);
+            }
+        }
+    };
+
+    // upper bound on the number of levels in any `Lod_chain`
+    constexpr size_t max_lod_levels = 4;
+
+    // Progressively coarser versions of one mesh, finest (level 0) first
+    struct Lod_chain {
+        std::vector<Triangle_mesh> levels;
+
+        // mesh-space distance that each level's surface may be from the
+        // true surface (parallel to `levels`)
+        std::vector<float> errors;
+
+        // radius of a mesh-space sphere, centered on the origin, that
+        // bounds the mesh
+        float radius = 0.0f;
+
+        Triangle_mesh& finest() {
+            return levels.front();
+        }
+    };
+
+    // LODs of the simbody cylinder: 24, 12 and 6 sides. The deviation of an
+    // n-gon from its circumcircle is 1 - cos(pi/n) radii.
+    Lod_chain gen_cylinder_lods(gl::Attribute& in_attr, gl::Attribute& normal_attr) {
+        Lod_chain rv;
+        rv.radius = std::sqrt(2.0f);
+        for (unsigned num_sides : {24u, 12u, 6u}) {
+            rv.levels.emplace_back(in_attr, normal_attr, simbody_cylinder_triangles(num_sides));
+            rv.errors.push_back(1.0f - std::cos(pi_f / static_cast<float>(num_sides)));
+        }
+        return rv;
+    }
+
+    // LODs of the unit sphere: icospheres with 1280, 320, 80 and 20 triangles
+    Lod_chain gen_sphere_lods(gl::Attribute& in_attr, gl::Attribute& normal_attr) {
+        static_assert(max_lod_levels >= 4);
+
+        Lod_chain rv;
+        rv.radius = 1.0f;
+        for (unsigned subdivisions : {3u, 2u, 1u, 0u}) {
+            auto points = icosphere_triangles(subdivisions);
+            rv.levels.emplace_back(in_attr, normal_attr, points);
+            rv.errors.push_back(unit_sphere_error(points));
+        }
+        return rv;
+    }
+
+    // Per-instance data for `instanced_vertex_shader_src`. The layout must
+    // match the `instance_modelMat` and `instance_rgba` attributes.
+    struct Instance_data {
+        glm::mat4 model_mat;
+        glm::vec4 rgba;
+    };
+
+    // A set of instances of one mesh (e.g. all spheres in the scene) that is
+    // drawn with one glDrawArraysInstanced call, rather than one glDrawArrays
+    // (+ uniform uploads) per instance
+    struct Instanced_batch {
+        GLsizei num_verts;
+        GLsizei num_instances = 0;
+        gl::Array_buffer instances;
+        gl::Vertex_array vao;
+
+        Instanced_batch(gl::Attribute& in_attr,
+                        gl::Attribute& normal_attr,
+                        gl::Attribute& model_mat_attr,
+                        gl::Attribute& rgba_attr,
+                        Triangle_mesh& mesh) :
+            num_verts{mesh.num_verts} {
+
+            gl::BindVertexArray(vao);
+            {
+                // per-vertex data comes from the (shared) mesh VBO
+                gl::BindBuffer(mesh.vbo);
+                gl::VertexAttributePointer(in_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), 0);
+                gl::VertexAttributePointer(normal_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), (void*)sizeof(Vec3));
+                gl::EnableVertexAttribArray(in_attr);
+                gl::EnableVertexAttribArray(normal_attr);
+
+                // per-instance data comes from this batch's buffer. A mat4
+                // attribute occupies 4 consecutive (vec4) locations.
+                gl::BindBuffer(instances);
+                for (GLuint col = 0; col < 4; ++col) {
+                    GLuint loc = static_cast<GLuint>(static_cast<GLint>(model_mat_attr)) + col;
+                    glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(Instance_data), (void*)(col * sizeof(glm::vec4)));
+                    glEnableVertexAttribArray(loc);
+                    glVertexAttribDivisor(loc, 1);
+                }
+                gl::VertexAttributePointer(rgba_attr, 4, GL_FLOAT, GL_FALSE, sizeof(Instance_data), (void*)offsetof(Instance_data, rgba));
+                gl::EnableVertexAttribArray(rgba_attr);
+                gl::VertexAttribDivisor(rgba_attr, 1);
+            }
+            gl::BindVertexArray();
+        }
+
+        void upload(std::vector<Instance_data> const& data) {
+            gl::BindBuffer(instances);
+            gl::BufferData(instances, sizeof(Instance_data) * data.size(), data.data(), GL_STATIC_DRAW);
+            num_instances = static_cast<GLsizei>(data.size());
+        }
+
+        // returns the number of draw calls issued (0 or 1)
+        int draw() {
+            if (num_instances == 0) {
+                return 0;
+            }
+            gl::BindVertexArray(vao);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, num_verts, num_instances);
+            gl::BindVertexArray();
+            return 1;
+        }
+    };
+
+    // Like `Instanced_batch`, but for instance data that changes every frame
+    // (e.g. muscle paths). Instances are written straight into a
+    // `gl::Stream_buffer`, so per-frame updates neither allocate GL objects
+    // nor stall on draws that are still in flight.
+    struct Streamed_batch {
+        GLsizei num_verts;
+        GLsizei num_instances = 0;
+        gl::Stream_buffer instances;
+        gl::Vertex_array vao;
+        GLuint model_mat_loc;
+        GLuint rgba_loc;
+
+        Streamed_batch(gl::Attribute& in_attr,
+                       gl::Attribute& normal_attr,
+                       gl::Attribute& model_mat_attr,
+                       gl::Attribute& rgba_attr,
+                       Triangle_mesh& mesh) :
+            num_verts{mesh.num_verts},
+            model_mat_loc{static_cast<GLuint>(static_cast<GLint>(model_mat_attr))},
+            rgba_loc{static_cast<GLuint>(static_cast<GLint>(rgba_attr))} {
+
+            gl::BindVertexArray(vao);
+            {
+                gl::BindBuffer(mesh.vbo);
+                gl::VertexAttributePointer(in_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), 0);
+                gl::VertexAttributePointer(normal_attr, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh_point), (void*)sizeof(Vec3));
+                gl::EnableVertexAttribArray(in_attr);
+                gl::EnableVertexAttribArray(normal_attr);
+
+                // instance attribute pointers move with the ring: they are
+                // set by `unmap`
+                for (GLuint col = 0; col < 4; ++col) {
+                    glEnableVertexAttribArray(model_mat_loc + col);
+                    glVertexAttribDivisor(model_mat_loc + col, 1);
+                }
+                glEnableVertexAttribArray(rgba_loc);
+                glVertexAttribDivisor(rgba_loc, 1);
+            }
+            gl::BindVertexArray();
+        }
+
+        // returns space for `n` instances, which must all be written before
+        // calling `unmap`
+        Instance_data* map(size_t n) {
+            num_instances = static_cast<GLsizei>(n);
+            return reinterpret_cast<Instance_data*>(instances.map(n * sizeof(Instance_data)));
+        }
+
+        void unmap() {
+            instances.unmap();
+
+            // point the instance attributes at the region that was just written
+            size_t base = instances.offset();
+            gl::BindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, instances);
+            for (GLuint col = 0; col < 4; ++col) {
+                glVertexAttribPointer(model_mat_loc + col, 4, GL_FLOAT, GL_FALSE, sizeof(Instance_data), (void*)(base + col * sizeof(glm::vec4)));
+            }
+            glVertexAttribPointer(rgba_loc, 4, GL_FLOAT, GL_FALSE, sizeof(Instance_data), (void*)(base + offsetof(Instance_data, rgba)));
+            gl::BindVertexArray();
+        }
+
+        // returns the number of draw calls issued (0 or 1)
+        int draw() {
+            if (num_instances == 0) {
+                return 0;
+            }
+            gl::BindVertexArray(vao);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, num_verts, num_instances);
+            gl::BindVertexArray();
+            instances.fence();
+            return 1;
+        }
+    };
+
+    // Program + batches used by the instanced rendering path
+    struct Instanced_glstate {
+        gl::Program program;
+
+        gl::UniformMatrix4fv projMat;
+        gl::UniformMatrix4fv viewMat;
+        gl::UniformVec3f light_pos;
+        gl::UniformVec3f light_color;
+        gl::UniformVec3f view_pos;
+
+        gl::Attribute location;
+        gl::Attribute in_normal;
+        gl::Attribute instance_modelMat;
+        gl::Attribute instance_rgba;
+
+        // one batch per level of the cylinder/sphere `Lod_chain`s
+        std::vector<Instanced_batch> cylinders;
+        std::vector<Instanced_batch> spheres;
+        Streamed_batch lines;
+    };
+
+    Instanced_glstate initialize_instanced(Lod_chain& cylinder, Lod_chain& sphere) {
+        auto program = gl::Program{};
+        auto vertex_shader = gl::Vertex_shader::Compile(instanced_vertex_shader_src);
+        gl::AttachShader(program, vertex_shader);
+        auto frag_shader = gl::Fragment_shader::Compile(frag_shader_src);
+        gl::AttachShader(program, frag_shader);
+
+        gl::LinkProgram(program);
+
+        auto location = gl::Attribute{program, "location"};
+        auto in_normal = gl::Attribute{program, "in_normal"};
+        auto instance_modelMat = gl::Attribute{program, "instance_modelMat"};
+        auto instance_rgba = gl::Attribute{program, "instance_rgba"};
+
+        auto projMat = gl::UniformMatrix4fv{program, "projMat"};
+        auto viewMat = gl::UniformMatrix4fv{program, "viewMat"};
+        auto light_pos = gl::UniformVec3f{program, "lightPos"};
+        auto light_color = gl::UniformVec3f{program, "lightColor"};
+        auto view_pos = gl::UniformVec3f{program, "viewPos"};
+
+        std::vector<Instanced_batch> cylinders;
+        for (Triangle_mesh& level : cylinder.levels) {
+            cylinders.emplace_back(location, in_normal, instance_modelMat, instance_rgba, level);
+        }
+        std::vector<Instanced_batch> spheres;
+        for (Triangle_mesh& level : sphere.levels) {
+            spheres.emplace_back(location, in_normal, instance_modelMat, instance_rgba, level);
+        }
+        // lines are thin, so they aren't worth LOD-ing
+        auto lines = Streamed_batch{location, in_normal, instance_modelMat, instance_rgba, cylinder.finest()};
+
+        return Instanced_glstate{
+            .program = std::move(program),
+
+            .projMat = std::move(projMat),
+            .viewMat = std::move(viewMat),
+            .light_pos = std::move(light_pos),
+            .light_color = std::move(light_color),
+            .view_pos = std::move(view_pos),
+
+            .location = std::move(location),
+            .in_normal = std::move(in_normal),
+            .instance_modelMat = std::move(instance_modelMat),
+            .instance_rgba = std::move(instance_rgba),
+
+            .cylinders = std::move(cylinders),
+            .spheres = std::move(spheres),
+            .lines = std::move(lines),
+        };
+    }
+
+    struct App_static_glstate {
+        gl::Program program;
+
+        gl::UniformMatrix4fv projMat;
+        gl::UniformMatrix4fv viewMat;
+        gl::UniformMatrix4fv modelMat;
+        gl::UniformVec4f rgba;
+        gl::UniformVec3f light_pos;
+        gl::UniformVec3f light_color;
+        gl::UniformVec3f view_pos;
+
+        gl::Attribute location;
+        gl::Attribute in_normal;
+
+        Lod_chain cylinder;
+        Lod_chain sphere;
+        Triangle_mesh box;  // see `unit_cube_triangles`
+
+        Instanced_glstate instanced;
+    };
+
+    App_static_glstate initialize() {
+        auto program = gl::Program{};
+        auto vertex_shader = gl::Vertex_shader::Compile(vertex_shader_src);
+        gl::AttachShader(program, vertex_shader);
+        auto frag_shader = gl::Fragment_shader::Compile(frag_shader_src);
+        gl::AttachShader(program, frag_shader);
+
+        gl::LinkProgram(program);
+
+        auto projMat = gl::UniformMatrix4fv{program, "projMat"};
+        auto viewMat = gl::UniformMatrix4fv{program, "viewMat"};
+        auto modelMat = gl::UniformMatrix4fv{program, "modelMat"};
+        auto rgba = gl::UniformVec4f{program, "rgba"};
+        auto light_pos = gl::UniformVec3f{program, "lightPos"};
+        auto light_color = gl::UniformVec3f{program, "lightColor"};
+        auto view_pos = gl::UniformVec3f{program, "viewPos"};
+
+        auto in_position = gl::Attribute{program, "location"};
+        auto in_normal = gl::Attribute{program, "in_normal"};
+
+        auto cylinder = gen_cylinder_lods(in_position, in_normal);
+        auto sphere = gen_sphere_lods(in_position, in_normal);
+        auto box = Triangle_mesh{in_position, in_normal, unit_cube_triangles()};
+        auto instanced = initialize_instanced(cylinder, sphere);
+
+        return App_static_glstate {
+            .program = std::move(program),
+
+            .projMat = std::move(projMat),
+            .viewMat = std::move(viewMat),
+            .modelMat = std::move(modelMat),
+            .rgba = std::move(rgba),
+            .light_pos = std::move(light_pos),
+            .light_color = std::move(light_color),
+            .view_pos = std::move(view_pos),
+
+            .location = std::move(in_position),
+            .in_normal = std::move(in_normal),
+
+            .cylinder = std::move(cylinder),
+            .sphere = std::move(sphere),
+            .box = std::move(box),
+
+            .instanced = std::move(instanced),
+        };
+    }
+
+    Triangle_mesh make_mesh(gl::Attribute& in_attr, gl::Attribute& in_normal, osim::Mesh_data const& data) {
+        return std::visit([&](auto const& indices) {
+            return Triangle_mesh{in_attr, in_normal, data.vertices, indices};
+        }, data.indices);
+    }
+
+    // uploads `data` as level 0, followed by its decimations (see
+    // `osim::decimation_chain`). `lods` are the decimations, if they have
+    // already been computed (e.g. by a background thread).
+    Lod_chain make_mesh_lods(gl::Attribute& in_attr,
+                             gl::Attribute& in_normal,
+                             osim::Mesh_data const& data,
+                             std::vector<osim::Mesh_lod> const* lods = nullptr) {
+        Lod_chain rv;
+        rv.levels.push_back(make_mesh(in_attr, in_normal, data));
+        rv.errors.push_back(0.0f);
+        for (osim::Mesh_vertex const& v : data.vertices) {
+            rv.radius = std::max(rv.radius, glm::length(v.position));
+        }
+
+        std::vector<osim::Mesh_lod> computed;
+        if (lods == nullptr) {
+            computed = osim::decimation_chain(data, max_lod_levels - 1);
+            lods = &computed;
+        }
+        for (osim::Mesh_lod const& lod : *lods) {
+            rv.levels.push_back(make_mesh(in_attr, in_normal, lod.data));
+            rv.errors.push_back(lod.error);
+        }
+        return rv;
+    }
+
+    // Axis-aligned bounding box
+    struct AABB {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    AABB aabb_union(AABB const& a, AABB const& b) {
+        return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    glm::vec3 aabb_center(AABB const& a) {
+        return (a.min + a.max) / 2.0f;
+    }
+
+    // Returns the bounds of `local` after it has been transformed by `m`:
+    //     https://zeux.io/2010/10/17/aabb-from-obb-with-component-wise-abs/
+    AABB transform_aabb(glm::mat4 const& m, AABB const& local) {
+        glm::vec3 center = glm::vec3{m * glm::vec4{aabb_center(local), 1.0f}};
+        glm::vec3 half = (local.max - local.min) / 2.0f;
+
+        glm::vec3 extent = {0.0f, 0.0f, 0.0f};
+        for (int col = 0; col < 3; ++col) {
+            extent += glm::abs(glm::vec3{m[col]}) * half[col];
+        }
+        return AABB{center - extent, center + extent};
+    }
+
+    AABB mesh_bounds(osim::Mesh_data const& data) {
+        if (data.vertices.empty()) {
+            return AABB{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        }
+        AABB rv{data.vertices.front().position, data.vertices.front().position};
+        for (osim::Mesh_vertex const& v : data.vertices) {
+            rv.min = glm::min(rv.min, v.position);
+            rv.max = glm::max(rv.max, v.position);
+        }
+        return rv;
+    }
+
+    // Which elements of a scene are visible, per type (parallel to the
+    // scene's arrays)
+    struct Visibility {
+        std::vector<std::uint8_t> cylinders;
+        std::vector<std::uint8_t> spheres;
+        std::vector<std::uint8_t> lines;
+        std::vector<std::uint8_t> meshes;
+        size_t drawn = 0;
+        size_t culled = 0;
+
+        void reset(osim::Scene const& scene, std::uint8_t value) {
+            cylinders.assign(scene.cylinders.size(), value);
+            spheres.assign(scene.spheres.size(), value);
+            lines.assign(scene.lines.size(), value);
+            meshes.assign(scene.meshes.size(), value);
+            size_t n = cylinders.size() + spheres.size() + lines.size() + meshes.size();
+            drawn = value ? n : 0;
+            culled = value ? 0 : n;
+        }
+    };
+
+    // View frustum, as 6 inward-facing planes (`dot(n, p) + d >= 0` inside)
+    struct Frustum {
+        std::array<glm::vec4, 6> planes;
+
+        // extracts the planes from a `proj * view` matrix:
+        //     Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes
+        //     from the World-View-Projection Matrix"
+        Frustum(glm::mat4 const& view_proj) {
+            auto row = [&](int i) {
+                return glm::vec4{view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]};
+            };
+            planes = {
+                row(3) + row(0), row(3) - row(0),
+                row(3) + row(1), row(3) - row(1),
+                row(3) + row(2), row(3) - row(2),
+            };
+        }
+    };
+
+    enum class Frustum_test { outside, intersecting, inside };
+
+    Frustum_test test(Frustum const& f, AABB const& box) {
+        Frustum_test rv = Frustum_test::inside;
+        for (glm::vec4 const& p : f.planes) {
+            glm::vec3 n{p};
+            // the box corner furthest along (and the one furthest against)
+            // the plane normal
+            glm::vec3 furthest = glm::mix(box.min, box.max, glm::greaterThanEqual(n, glm::vec3{0.0f}));
+            glm::vec3 nearest = glm::mix(box.max, box.min, glm::greaterThanEqual(n, glm::vec3{0.0f}));
+            if (glm::dot(n, furthest) + p.w < 0.0f) {
+                return Frustum_test::outside;
+            }
+            if (glm::dot(n, nearest) + p.w < 0.0f) {
+                rv = Frustum_test::intersecting;
+            }
+        }
+        return rv;
+    }
+
+    // Bounding volume hierarchy over every element of a scene
+    //
+    // Built once per scene layout. When only transforms change (e.g. the
+    // model is re-posed), it is refit (bounds recomputed bottom-up, topology
+    // kept) rather than rebuilt.
+    class Scene_bvh {
+        enum class Kind : std::uint8_t { cylinder, sphere, line, mesh };
+
+        struct Prim {
+            Kind kind;
+            std::uint32_t index;  // into the scene's arrays for `kind`
+        };
+
+        // children of an internal node are at `first` and `first + 1`. A
+        // node's children always come after it in `nodes`.
+        struct Node {
+            AABB bounds;
+            std::uint32_t first;  // first child (internal) or first prim (leaf)
+            std::uint32_t count;  // number of prims (leaf), or 0 (internal)
+        };
+
+        static constexpr std::uint32_t max_leaf_size = 4;
+
+        std::vector<Prim> prims;
+        std::vector<AABB> prim_bounds;  // parallel to `prims`
+        std::vector<Node> nodes;
+        size_t num_cylinders = 0;
+        size_t num_spheres = 0;
+        size_t num_lines = 0;
+        size_t num_meshes = 0;
+
+        static AABB bounds_of(Prim p, osim::Scene const& scene, std::span<AABB const> mesh_bounds, float line_width) {
+            // simbody's unit cylinder and sphere both fit in [-1, 1]^3
+            AABB unit{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+
+            switch (p.kind) {
+            case Kind::cylinder:
+                return transform_aabb(glm::scale(scene.cylinders.transforms[p.index], scene.cylinders.scales[p.index]), unit);
+            case Kind::sphere: {
+                float r = scene.spheres.radii[p.index];
+                return transform_aabb(glm::scale(scene.spheres.transforms[p.index], glm::vec3{r, r, r}), unit);
+            }
+            case Kind::line: {
+                glm::vec3 const& p1 = scene.lines.p1s[p.index];
+                glm::vec3 const& p2 = scene.lines.p2s[p.index];
+                glm::vec3 pad{line_width, line_width, line_width};
+                return AABB{glm::min(p1, p2) - pad, glm::max(p1, p2) + pad};
+            }
+            case Kind::mesh: {
+                glm::mat4 m = glm::scale(scene.meshes.transforms[p.index], scene.meshes.scales[p.index]);
+                return transform_aabb(m, mesh_bounds[scene.meshes.pool_indices[p.index]]);
+            }
+            }
+            return unit;
+        }
+
+        // builds the subtree for prims [begin, end) into `nodes[node]`
+        void build(std::uint32_t node, std::uint32_t begin, std::uint32_t end) {
+            AABB bounds = prim_bounds[begin];
+            AABB centroids{aabb_center(bounds), aabb_center(bounds)};
+            for (std::uint32_t i = begin; i < end; ++i) {
+                bounds = aabb_union(bounds, prim_bounds[i]);
+                glm::vec3 c = aabb_center(prim_bounds[i]);
+                centroids = aabb_union(centroids, AABB{c, c});
+            }
+            nodes[node].bounds = bounds;
+
+            if (end - begin <= max_leaf_size) {
+                nodes[node].first = begin;
+                nodes[node].count = end - begin;
+                return;
+            }
+
+            // median split along the longest axis of the centroids
+            glm::vec3 extent = centroids.max - centroids.min;
+            int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+            std::uint32_t mid = begin + (end - begin)/2;
+
+            std::vector<std::uint32_t> order(end - begin);
+            for (std::uint32_t i = 0; i < order.size(); ++i) {
+                order[i] = begin + i;
+            }
+            std::nth_element(order.begin(), order.begin() + (mid - begin), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+                return aabb_center(prim_bounds[a])[axis] < aabb_center(prim_bounds[b])[axis];
+            });
+            std::vector<Prim> sorted_prims;
+            std::vector<AABB> sorted_bounds;
+            sorted_prims.reserve(order.size());
+            sorted_bounds.reserve(order.size());
+            for (std::uint32_t i : order) {
+                sorted_prims.push_back(prims[i]);
+                sorted_bounds.push_back(prim_bounds[i]);
+            }
+            std::copy(sorted_prims.begin(), sorted_prims.end(), prims.begin() + begin);
+            std::copy(sorted_bounds.begin(), sorted_bounds.end(), prim_bounds.begin() + begin);
+
+            auto first_child = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(Node{});
+            nodes.push_back(Node{});
+            nodes[node].first = first_child;
+            nodes[node].count = 0;
+            build(first_child, begin, mid);
+            build(first_child + 1, mid, end);
+        }
+
+        void mark(Prim p, Visibility& out) const {
+            switch (p.kind) {
+            case Kind::cylinder: out.cylinders[p.index] = 1; break;
+            case Kind::sphere: out.spheres[p.index] = 1; break;
+            case Kind::line: out.lines[p.index] = 1; break;
+            case Kind::mesh: out.meshes[p.index] = 1; break;
+            }
+        }
+
+        void mark_all(Node const& n, Visibility& out) const {
+            if (n.count > 0) {
+                for (std::uint32_t i = n.first; i < n.first + n.count; ++i) {
+                    mark(prims[i], out);
+                }
+                out.drawn += n.count;
+                out.culled -= n.count;
+            } else {
+                mark_all(nodes[n.first], out);
+                mark_all(nodes[n.first + 1], out);
+            }
+        }
+
+        void cull(Node const& n, Frustum const& f, Visibility& out) const {
+            switch (test(f, n.bounds)) {
+            case Frustum_test::outside:
+                return;
+            case Frustum_test::inside:
+                mark_all(n, out);
+                return;
+            case Frustum_test::intersecting:
+                break;
+            }
+
+            if (n.count > 0) {
+                for (std::uint32_t i = n.first; i < n.first + n.count; ++i) {
+                    if (test(f, prim_bounds[i]) != Frustum_test::outside) {
+                        mark(prims[i], out);
+                        ++out.drawn;
+                        --out.culled;
+                    }
+                }
+            } else {
+                cull(nodes[n.first], f, out);
+                cull(nodes[n.first + 1], f, out);
+            }
+        }
+
+    public:
+        // builds the BVH from scratch
+        void build(osim::Scene const& scene, std::span<AABB const> mesh_bounds, float line_width) {
+            num_cylinders = scene.cylinders.size();
+            num_spheres = scene.spheres.size();
+            num_lines = scene.lines.size();
+            num_meshes = scene.meshes.size();
+
+            prims.clear();
+            auto add = [&](Kind k, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    prims.push_back(Prim{k, static_cast<std::uint32_t>(i)});
+                }
+            };
+            add(Kind::cylinder, num_cylinders);
+            add(Kind::sphere, num_spheres);
+            add(Kind::line, num_lines);
+            add(Kind::mesh, num_meshes);
+
+            prim_bounds.clear();
+            for (Prim p : prims) {
+                prim_bounds.push_back(bounds_of(p, scene, mesh_bounds, line_width));
+            }
+
+            nodes.clear();
+            if (prims.empty()) {
+                return;
+            }
+            nodes.push_back(Node{});
+            build(0, 0, static_cast<std::uint32_t>(prims.size()));
+        }
+
+        // recomputes all bounds for the scene's current transforms, keeping
+        // the tree's topology. Falls back to `build` if the scene's layout
+        // (number of elements of each type) has changed.
+        void refit(osim::Scene const& scene, std::span<AABB const> mesh_bounds, float line_width) {
+            if (scene.cylinders.size() != num_cylinders
+                or scene.spheres.size() != num_spheres
+                or scene.lines.size() != num_lines
+                or scene.meshes.size() != num_meshes) {
+                build(scene, mesh_bounds, line_width);
+                return;
+            }
+
+            for (size_t i = 0; i < prims.size(); ++i) {
+                prim_bounds[i] = bounds_of(prims[i], scene, mesh_bounds, line_width);
+            }
+
+            // children always come after their parent, so a reverse pass
+            // visits every child before its parent
+            for (size_t i = nodes.size(); i-- > 0;) {
+                Node& n = nodes[i];
+                if (n.count > 0) {
+                    n.bounds = prim_bounds[n.first];
+                    for (std::uint32_t j = n.first + 1; j < n.first + n.count; ++j) {
+                        n.bounds = aabb_union(n.bounds, prim_bounds[j]);
+                    }
+                } else {
+                    n.bounds = aabb_union(nodes[n.first].bounds, nodes[n.first + 1].bounds);
+                }
+            }
+        }
+
+        // bounds of the whole scene, if it has anything in it
+        std::optional<AABB> bounds() const {
+            if (nodes.empty()) {
+                return std::nullopt;
+            }
+            return nodes.front().bounds;
+        }
+
+        // writes which elements of `scene` intersect the view frustum of
+        // `view_proj` to `out`
+        void cull(osim::Scene const& scene, glm::mat4 const& view_proj, Visibility& out) const {
+            out.reset(scene, 0);
+            if (not nodes.empty()) {
+                cull(nodes.front(), Frustum{view_proj}, out);
+            }
+        }
+    };
+
+    // Cache of uploaded meshes (+ their LODs), keyed by the mesh cache handle
+    // that `osim::scene_in` assigns to each distinct mesh. Lives as long as
+    // the GL context, so that every decoration (in every model loaded in the
+    // session) that uses the same mesh shares one set of VBOs/EBOs/VAOs, and
+    // each mesh is only decimated once.
+    struct Mesh_gpu_cache {
+        std::unordered_map<osim::Mesh_id, std::shared_ptr<Lod_chain>> meshes;
+        std::unordered_map<osim::Mesh_id, AABB> bounds;  // mesh-space
+        size_t hits = 0;
+        size_t misses = 0;
+
+        std::shared_ptr<Lod_chain> get(gl::Attribute& in_attr,
+                                       gl::Attribute& in_normal,
+                                       osim::Mesh_id id,
+                                       osim::Mesh_data const& data,
+                                       std::vector<osim::Mesh_lod> const* lods = nullptr) {
+            if (auto it = meshes.find(id); it != meshes.end()) {
+                ++hits;
+                return it->second;
+            }
+
+            ++misses;
+            auto uploaded = std::make_shared<Lod_chain>(make_mesh_lods(in_attr, in_normal, data, lods));
+            meshes.emplace(id, uploaded);
+            bounds.emplace(id, mesh_bounds(data));
+            return uploaded;
+        }
+    };
+
+    using Mesh_lods = std::shared_ptr<std::vector<osim::Mesh_lod> const>;
+
+    // How much of a mesh is on the GPU: nothing (its bounds are drawn as a
+    // box), a proxy (its coarsest LOD), or its whole LOD chain
+    enum class Mesh_residency : std::uint8_t { pending, proxy, resident };
+
+    // A model, and everything needed to draw it. A default-constructed
+    // ModelState has no session, and an empty scene: it is what is shown
+    // while the first model is still loading.
+    struct ModelState {
+        std::string path;
+        std::optional<osim::ModelSession> session;
+        osim::Scene scene;
+
+        // uploaded meshes (+ their mesh-space bounds), parallel to
+        // `scene.mesh_pool`. When meshes are streamed (see `Mesh_streamer`)
+        // a mesh's entry is null until it is at least a proxy.
+        std::vector<std::shared_ptr<Lod_chain>> gpu_meshes;
+        std::vector<AABB> mesh_bounds;
+
+        // only used when meshes are streamed (parallel to `scene.mesh_pool`)
+        std::vector<Mesh_residency> residency;
+        std::vector<Mesh_lods> lods;  // precomputed decimations, if any
+
+        // kept up to date with `scene` (via `Scene_bvh::refit`) by the UI
+        // loop, because it depends on `line_width`
+        Scene_bvh bvh;
+
+        ModelState() = default;
+
+        // throws if the model cannot be loaded
+        ModelState(std::string_view _path) : path{_path}, session{std::in_place, _path} {
+        }
+    };
+
+    // ensures mesh `i` of `ms.scene.mesh_pool` is on the GPU, and appends it
+    // to `ms.gpu_meshes`. `lods` are its precomputed decimations, if any.
+    // Must be called on the GL thread.
+    void upload_mesh(App_static_glstate& gls,
+                     Mesh_gpu_cache& mesh_cache,
+                     ModelState& ms,
+                     size_t i,
+                     std::vector<osim::Mesh_lod> const* lods = nullptr) {
+        osim::Mesh_pool const& pool = ms.scene.mesh_pool;
+        ms.gpu_meshes.push_back(mesh_cache.get(gls.location, gls.in_normal, pool.ids[i], *pool.data[i], lods));
+        ms.mesh_bounds.push_back(mesh_cache.bounds.at(pool.ids[i]));
+    }
+
+    // ensures every mesh in `ms.scene` is on the GPU. Must be called on the
+    // GL thread, unlike scene extraction.
+    void upload_meshes(App_static_glstate& gls, Mesh_gpu_cache& mesh_cache, ModelState& ms) {
+        size_t n = ms.scene.mesh_pool.size();
+        ms.gpu_meshes.clear();
+        ms.gpu_meshes.reserve(n);
+        ms.mesh_bounds.clear();
+        ms.mesh_bounds.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            upload_mesh(gls, mesh_cache, ms, i);
+        }
+    }
+
+    // swaps `next` (another pose of the same model) into `ms.scene`, so
+    // `next` gets the old scene, whose storage can be re-used. Per-mesh state
+    // (uploaded meshes, bounds, residency, decimations) is carried over by
+    // mesh ID, so a pose change never uploads anything: a mesh that is new to
+    // the model (rare) starts out pending.
+    void replace_scene(ModelState& ms, osim::Scene& next) {
+        std::unordered_map<osim::Mesh_id, size_t> old_index;
+        for (size_t i = 0; i < ms.scene.mesh_pool.size(); ++i) {
+            old_index.emplace(ms.scene.mesh_pool.ids[i], i);
+        }
+        auto old_gpu_meshes = std::move(ms.gpu_meshes);
+        auto old_bounds = std::move(ms.mesh_bounds);
+        auto old_residency = std::move(ms.residency);
+        auto old_lods = std::move(ms.lods);
+
+        std::swap(ms.scene, next);
+
+        osim::Mesh_pool const& pool = ms.scene.mesh_pool;
+        ms.gpu_meshes.clear();
+        ms.mesh_bounds.clear();
+        ms.residency.clear();
+        ms.lods.clear();
+        for (size_t i = 0; i < pool.size(); ++i) {
+            if (auto it = old_index.find(pool.ids[i]); it != old_index.end()) {
+                size_t j = it->second;
+                ms.gpu_meshes.push_back(old_gpu_meshes[j]);
+                ms.mesh_bounds.push_back(old_bounds[j]);
+                ms.residency.push_back(j < old_residency.size() ? old_residency[j] : Mesh_residency::resident);
+                ms.lods.push_back(j < old_lods.size() ? old_lods[j] : nullptr);
+            } else {
+                ms.gpu_meshes.push_back(nullptr);
+                ms.mesh_bounds.push_back(mesh_bounds(*pool.data[i]));
+                ms.residency.push_back(Mesh_residency::pending);
+                ms.lods.push_back(nullptr);
+            }
+        }
+    }
+
+    // How long each stage of a pose change took, in `Pose_pipeline`
+    struct Pose_latency {
+        float queued_ms = 0.0f;   // submitted -> picked up by the worker
+        float extract_ms = 0.0f;  // pose applied + its scene extracted
+        float handoff_ms = 0.0f;  // extracted -> swapped in by the UI
+        float present_ms = 0.0f;  // swapped in -> on screen
+
+        float total_ms() const {
+            return queued_ms + extract_ms + handoff_ms + present_ms;
+        }
+    };
+
+    // Applies poses to a model, and extracts their scenes, on a worker
+    // thread, so the UI thread never runs decoration generation.
+    //
+    // The UI `submit`s a pose (one value per coordinate). The worker applies
+    // it to the session and extracts its scene into the back buffer, while
+    // the UI keeps drawing the front buffer (`ModelState::scene`), and `poll`
+    // swaps the two once extraction is done. So a frame costs max(extract,
+    // render), rather than their sum. Poses submitted while the worker is
+    // busy replace each other, so it always goes straight to the latest one.
+    //
+    // The worker uses the session that was last submitted with, so the UI
+    // must `wait_idle` (or `cancel`) before it uses (or destroys) it.
+    class Pose_pipeline final {
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            std::vector<double> values;
+            Clock::time_point submitted;
+        };
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        osim::ModelSession* session = nullptr;
+        std::optional<Job> pending;
+        bool working = false;
+        bool stopping = false;
+        std::string error;
+
+        // only touched by the worker while `working`, and by the UI while
+        // `back_ready`
+        osim::Scene back;
+        bool back_ready = false;
+        Pose_latency back_latency;
+        Clock::time_point back_done;
+
+        // UI-side: the pose that was swapped in last (until it's presented),
+        // and the latencies of recently presented poses
+        std::optional<std::pair<Pose_latency, Clock::time_point>> unpresented;
+        std::deque<Pose_latency> history;
+
+        std::thread thread;
+
+        static float ms_between(Clock::time_point a, Clock::time_point b) {
+            return std::chrono::duration<float, std::milli>{b - a}.count();
+        }
+
+        void run() {
+            std::unique_lock lock{mutex};
+            while (true) {
+                cv.wait(lock, [&]() { return stopping or (pending and not back_ready); });
+                if (stopping) {
+                    return;
+                }
+                Job job = std::move(*pending);
+                pending.reset();
+                working = true;
+                osim::ModelSession* s = session;
+                lock.unlock();
+
+                Clock::time_point start = Clock::now();
+                std::string err;
+                try {
+                    s->set_coordinate_values(job.values);
+                    s->scene(back);
+                } catch (std::exception const& ex) {
+                    err = ex.what();
+                }
+                Clock::time_point done = Clock::now();
+
+                lock.lock();
+                working = false;
+                if (err.empty()) {
+                    back_ready = true;
+                    back_latency = Pose_latency{ms_between(job.submitted, start), ms_between(start, done), 0.0f, 0.0f};
+                    back_done = done;
+                } else {
+                    error = std::move(err);
+                }
+                cv.notify_all();
+            }
+        }
+
+    public:
+        static constexpr size_t history_size = 120;
+
+        Pose_pipeline() : thread{[this]() { run(); }} {
+        }
+        Pose_pipeline(Pose_pipeline const&) = delete;
+        Pose_pipeline& operator=(Pose_pipeline const&) = delete;
+        ~Pose_pipeline() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            thread.join();
+        }
+
+        void submit(osim::ModelSession& s, std::span<double const> values) {
+            {
+                std::lock_guard lock{mutex};
+                session = &s;
+                pending = Job{std::vector<double>(values.begin(), values.end()), Clock::now()};
+                error.clear();
+            }
+            cv.notify_all();
+        }
+
+        // swaps the latest extracted scene (if there is one) into `ms`.
+        // Returns true if it did.
+        bool poll(ModelState& ms) {
+            {
+                std::lock_guard lock{mutex};
+                if (not back_ready) {
+                    return false;
+                }
+                replace_scene(ms, back);
+                back_ready = false;
+
+                Clock::time_point now = Clock::now();
+                Pose_latency latency = back_latency;
+                latency.handoff_ms = ms_between(back_done, now);
+                unpresented.emplace(latency, now);
+            }
+            cv.notify_all();  // the back buffer is free again
+            return true;
+        }
+
+        // must be called once a frame is on screen
+        void frame_presented() {
+            if (not unpresented) {
+                return;
+            }
+            Pose_latency latency = unpresented->first;
+            latency.present_ms = ms_between(unpresented->second, Clock::now());
+            unpresented.reset();
+
+            history.push_back(latency);
+            if (history.size() > history_size) {
+                history.pop_front();
+            }
+        }
+
+        bool busy() {
+            std::lock_guard lock{mutex};
+            return pending or working or back_ready;
+        }
+
+        // waits until all submitted poses have been extracted, swapping each
+        // extracted scene into `ms` as it arrives (the worker can't start on
+        // the next pose until the back buffer is free). Returns true if
+        // `ms.scene` changed.
+        bool wait_idle(ModelState& ms) {
+            bool swapped = false;
+            while (true) {
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [&]() { return back_ready or (not pending and not working); });
+                    if (not back_ready) {
+                        return swapped;
+                    }
+                }
+                swapped = poll(ms) or swapped;
+            }
+        }
+
+        // drops pending poses (and any extracted scene), and waits for the
+        // one that's being extracted
+        void cancel() {
+            std::unique_lock lock{mutex};
+            pending.reset();
+            cv.wait(lock, [&]() { return not working; });
+            back_ready = false;
+            session = nullptr;
+        }
+
+        std::deque<Pose_latency> const& latencies() const noexcept {
+            return history;
+        }
+
+        std::string last_error() {
+            std::lock_guard lock{mutex};
+            return error;
+        }
+    };
+
+    // A model that `Model_loader` has loaded and extracted (including each
+    // mesh's bounds and decimations), but whose meshes are not yet on the GPU
+    struct Loaded_model {
+        std::uint64_t generation;
+        std::string path;
+        std::unique_ptr<ModelState> ms;  // null if loading failed
+        std::string error;
+    };
+
+    // Loads models on a background thread, so that the UI never blocks on
+    // OpenSim. Everything up to (but excluding) GL uploads happens on the
+    // thread: model construction, `initSystem`, scene extraction, and mesh
+    // decimation. Finished models are handed back through a queue, which the
+    // UI thread polls once per frame.
+    //
+    // Only the most recent request matters. A request that is superseded
+    // before the thread starts on it is skipped, one that is superseded while
+    // in progress is abandoned at the next stage boundary (OpenSim can't be
+    // interrupted mid-construction), and results of superseded requests are
+    // never returned by `poll`.
+    class Model_loader final {
+    public:
+        enum class Stage { idle, loading, extracting, simplifying };
+
+        struct Progress {
+            Stage stage = Stage::idle;
+            std::string path;
+            size_t done = 0;   // only used by `Stage::simplifying`
+            size_t total = 0;
+        };
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::optional<std::string> requested;  // not yet started by the thread
+        std::uint64_t generation = 0;          // of the most recent request
+        std::deque<Loaded_model> finished;
+        Progress current_progress;
+        bool stopping = false;
+
+        // only accessed by the loader thread. Meshes are shared between
+        // models, so they are only decimated once per session.
+        std::unordered_map<osim::Mesh_id, Mesh_lods> lods_cache;
+
+        // last, so that it starts after everything it uses is constructed
+        std::thread thread;
+
+        // updates the progress, and returns false if `gen` has been superseded
+        bool report(std::uint64_t gen, Stage stage, size_t done = 0, size_t total = 0) {
+            std::lock_guard lock{mutex};
+            current_progress.stage = stage;
+            current_progress.done = done;
+            current_progress.total = total;
+            return gen == generation;
+        }
+
+        Loaded_model load(std::uint64_t gen, std::string const& path) {
+            Loaded_model rv{gen, path, nullptr, {}};
+            try {
+                auto ms = std::make_unique<ModelState>(path);
+
+                if (not report(gen, Stage::extracting)) {
+                    return rv;
+                }
+                ms->session->scene(ms->scene);
+
+                osim::Mesh_pool const& pool = ms->scene.mesh_pool;
+                ms->lods.reserve(pool.size());
+                ms->mesh_bounds.reserve(pool.size());
+                for (size_t i = 0; i < pool.size(); ++i) {
+                    if (not report(gen, Stage::simplifying, i, pool.size())) {
+                        return rv;
+                    }
+                    Mesh_lods& lods = lods_cache[pool.ids[i]];
+                    if (not lods) {
+                        lods = std::make_shared<std::vector<osim::Mesh_lod> const>(
+                            osim::decimation_chain(*pool.data[i], max_lod_levels - 1));
+                    }
+                    ms->lods.push_back(lods);
+                    ms->mesh_bounds.push_back(mesh_bounds(*pool.data[i]));
+                }
+
+                rv.ms = std::move(ms);
+            } catch (std::exception const& ex) {
+                rv.error = ex.what();
+            }
+            return rv;
+        }
+
+        void run() {
+            while (true) {
+                std::string path;
+                std::uint64_t gen;
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [&]() { return stopping or requested.has_value(); });
+                    if (stopping) {
+                        return;
+                    }
+                    path = std::move(*requested);
+                    requested.reset();
+                    gen = generation;
+                    current_progress = Progress{Stage::loading, path, 0, 0};
+                }
+
+                Loaded_model loaded = load(gen, path);
+
+                std::lock_guard lock{mutex};
+                finished.push_back(std::move(loaded));
+                if (not requested) {
+                    current_progress = Progress{};
+                }
+            }
+        }
+
+    public:
+        Model_loader() : thread{[this]() { run(); }} {
+        }
+        Model_loader(Model_loader const&) = delete;
+        Model_loader& operator=(Model_loader const&) = delete;
+        ~Model_loader() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            thread.join();
+        }
+
+        // starts loading `path` (superseding any earlier request)
+        void request(std::string path) {
+            {
+                std::lock_guard lock{mutex};
+                requested = std::move(path);
+                ++generation;
+            }
+            cv.notify_all();
+        }
+
+        // returns the result of the most recent request, if it has finished
+        // (and hasn't already been returned). Never blocks on loading.
+        std::optional<Loaded_model> poll() {
+            std::lock_guard lock{mutex};
+            while (not finished.empty() and finished.front().generation != generation) {
+                finished.pop_front();
+            }
+            if (finished.empty()) {
+                return std::nullopt;
+            }
+            Loaded_model rv = std::move(finished.front());
+            finished.pop_front();
+            return rv;
+        }
+
+        Progress progress() {
+            std::lock_guard lock{mutex};
+            return current_progress;
+        }
+
+        // true if a request is queued, in progress, or waiting to be polled
+        bool busy() {
+            std::lock_guard lock{mutex};
+            return requested.has_value() or current_progress.stage != Stage::idle or not finished.empty();
+        }
+    };
+
+    char const* stage_name(Model_loader::Stage stage) {
+        switch (stage) {
+        case Model_loader::Stage::idle:
+            return "idle";
+        case Model_loader::Stage::loading:
+            return "loading model";
+        case Model_loader::Stage::extracting:
+            return "extracting geometry";
+        case Model_loader::Stage::simplifying:
+            return "simplifying meshes";
+        }
+        return "unknown";
+    }
+
+    // Work item for `Mesh_streamer`: upload one mesh, either as a proxy (just
+    // its coarsest LOD, so only for meshes that have decimated levels) or in
+    // full (its whole LOD chain)
+    struct Upload_job {
+        osim::Mesh_id id;
+        bool proxy;
+        std::shared_ptr<osim::Mesh_data const> data;
+        Mesh_lods lods;  // computed by the upload, if null
+
+        size_t bytes() const {
+            if (proxy) {
+                return size_bytes(lods and not lods->empty() ? lods->back().data : *data);
+            }
+            size_t rv = size_bytes(*data);
+            if (lods) {
+                for (osim::Mesh_lod const& lod : *lods) {
+                    rv += size_bytes(lod.data);
+                }
+            }
+            return rv;
+        }
+    };
+
+    struct Upload_result {
+        osim::Mesh_id id;
+        bool proxy;
+        std::vector<Mesh_buffers> levels;  // finest first
+        std::vector<float> errors;
+        float radius = 0.0f;
+        size_t bytes = 0;
+        GLsync fence = nullptr;  // set if the upload was done by another context
+    };
+
+    // uploads a job's buffers in the current context
+    Upload_result run_upload(Upload_job const& job) {
+        Upload_result rv{job.id, job.proxy, {}, {}, 0.0f, job.bytes(), nullptr};
+        for (osim::Mesh_vertex const& v : job.data->vertices) {
+            rv.radius = std::max(rv.radius, glm::length(v.position));
+        }
+
+        std::vector<osim::Mesh_lod> computed;
+        std::vector<osim::Mesh_lod> const* lods = job.lods.get();
+        if (lods == nullptr and not job.proxy) {
+            computed = osim::decimation_chain(*job.data, max_lod_levels - 1);
+            lods = &computed;
+        }
+
+        if (job.proxy) {
+            bool decimated = lods != nullptr and not lods->empty();
+            rv.levels.push_back(upload_buffers(decimated ? lods->back().data : *job.data));
+            rv.errors.push_back(decimated ? lods->back().error : 0.0f);
+        } else {
+            rv.levels.push_back(upload_buffers(*job.data));
+            rv.errors.push_back(0.0f);
+            for (osim::Mesh_lod const& lod : *lods) {
+                rv.levels.push_back(upload_buffers(lod.data));
+                rv.errors.push_back(lod.error);
+            }
+        }
+        return rv;
+    }
+
+    // Runs `Upload_job`s on a background thread that has its own GL context,
+    // which shares objects with the UI thread's context. Each finished job is
+    // fenced, and is only handed back (by `poll`) once the fence signals, so
+    // the UI thread never waits on an upload.
+    class Upload_worker final {
+        SDL_Window* window;
+        sdl::GLContext context;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Upload_job> jobs;
+        std::deque<Upload_result> results;
+        bool stopping = false;
+
+        std::thread thread;
+
+        void run(std::promise<bool>& started) {
+            if (SDL_GL_MakeCurrent(window, context) != 0) {
+                started.set_value(false);
+                return;
+            }
+            started.set_value(true);
+
+            while (true) {
+                Upload_job job;
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [&]() { return stopping or not jobs.empty(); });
+                    if (stopping) {
+                        break;
+                    }
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+
+                Upload_result result = run_upload(job);
+                result.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glFlush();  // so that the fence is visible to the other context
+
+                std::lock_guard lock{mutex};
+                results.push_back(std::move(result));
+            }
+
+            SDL_GL_MakeCurrent(window, nullptr);
+        }
+
+        Upload_worker(SDL_Window* _window, SDL_GLContext _context) :
+            window{_window}, context{_context} {
+        }
+
+    public:
+        // returns nullptr if a shared context can't be created or used. Must
+        // be called with `main_context` current.
+        static std::unique_ptr<Upload_worker> create(SDL_Window* window, SDL_GLContext main_context) {
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+            SDL_GLContext ctx = SDL_GL_CreateContext(window);
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+
+            // creating a context makes it current, so switch back
+            SDL_GL_MakeCurrent(window, main_context);
+            if (ctx == nullptr) {
+                std::cerr << "mesh streaming: cannot create a shared GL context (" << SDL_GetError() << "): uploading on the UI thread" << std::endl;
+                return nullptr;
+            }
+
+            std::unique_ptr<Upload_worker> rv{new Upload_worker{window, ctx}};
+            std::promise<bool> started;
+            rv->thread = std::thread{[w = rv.get(), &started]() { w->run(started); }};
+            if (not started.get_future().get()) {
+                rv->thread.join();
+                std::cerr << "mesh streaming: cannot make the shared GL context current (" << SDL_GetError() << "): uploading on the UI thread" << std::endl;
+                return nullptr;
+            }
+            return rv;
+        }
+
+        Upload_worker(Upload_worker const&) = delete;
+        Upload_worker& operator=(Upload_worker const&) = delete;
+        ~Upload_worker() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            if (thread.joinable()) {
+                thread.join();
+            }
+            for (Upload_result& r : results) {
+                glDeleteSync(r.fence);
+            }
+        }
+
+        void submit(Upload_job job) {
+            {
+                std::lock_guard lock{mutex};
+                jobs.push_back(std::move(job));
+            }
+            cv.notify_one();
+        }
+
+        // returns finished jobs whose uploads are visible to the UI context
+        std::vector<Upload_result> poll() {
+            std::vector<Upload_result> rv;
+            std::lock_guard lock{mutex};
+            while (not results.empty()) {
+                GLenum status = glClientWaitSync(results.front().fence, 0, 0);
+                if (status != GL_ALREADY_SIGNALED and status != GL_CONDITION_SATISFIED) {
+                    break;
+                }
+                glDeleteSync(results.front().fence);
+                results.front().fence = nullptr;
+                rv.push_back(std::move(results.front()));
+                results.pop_front();
+            }
+            return rv;
+        }
+    };
+
+    struct Streaming_stats {
+        size_t pending = 0;
+        size_t proxy = 0;
+        size_t resident = 0;
+        size_t in_flight = 0;
+        size_t proxy_uploads = 0;     // in total
+        size_t full_uploads = 0;      // in total
+        size_t bytes_uploaded = 0;    // in total
+        size_t bytes_last_frame = 0;  // dispatched by the last `schedule`
+    };
+
+    // Streams a model's meshes onto the GPU progressively, so that a huge
+    // model is drawable as soon as it has loaded: at first each mesh is drawn
+    // as its bounding box, then as a proxy (its coarsest LOD), and then in
+    // full. Meshes that are too small to have LODs skip the proxy, and are
+    // uploaded in full straight away. Proxies (and those small meshes) are
+    // uploaded for every mesh before any full mesh is, and each group is
+    // uploaded in priority order (biggest on-screen first), limited to a
+    // byte budget per frame.
+    //
+    // Uploads happen on an `Upload_worker` if a shared context is available,
+    // otherwise on the UI thread (still budgeted).
+    class Mesh_streamer final {
+        std::unique_ptr<Upload_worker> worker;
+        std::unordered_map<osim::Mesh_id, std::shared_ptr<Lod_chain>> proxies;
+        std::unordered_set<osim::Mesh_id> in_flight;
+        std::deque<Upload_result> finished_inline;
+        size_t proxy_uploads = 0;
+        size_t full_uploads = 0;
+        size_t bytes_uploaded = 0;
+        size_t bytes_last_frame = 0;
+
+        void integrate(App_static_glstate& gls, Mesh_gpu_cache& mesh_cache, ModelState& ms, Upload_result& r) {
+            in_flight.erase(r.id);
+            bytes_uploaded += r.bytes;
+            ++(r.proxy ? proxy_uploads : full_uploads);
+
+            auto chain = std::make_shared<Lod_chain>();
+            for (Mesh_buffers& level : r.levels) {
+                chain->levels.emplace_back(gls.location, gls.in_normal, std::move(level));
+            }
+            chain->errors = std::move(r.errors);
+            chain->radius = r.radius;
+
+            if (r.proxy) {
+                proxies[r.id] = chain;
+            } else {
+                mesh_cache.meshes[r.id] = chain;
+                proxies.erase(r.id);
+            }
+
+            // the model may have changed since the job was dispatched, so
+            // match by ID
+            osim::Mesh_pool const& pool = ms.scene.mesh_pool;
+            for (size_t i = 0; i < pool.size(); ++i) {
+                if (pool.ids[i] != r.id or ms.residency[i] == Mesh_residency::resident) {
+                    continue;
+                }
+                if (not r.proxy) {
+                    mesh_cache.bounds.emplace(r.id, ms.mesh_bounds[i]);
+                }
+                ms.gpu_meshes[i] = chain;
+                ms.residency[i] = r.proxy ? Mesh_residency::proxy : Mesh_residency::resident;
+            }
+        }
+
+    public:
+        explicit Mesh_streamer(std::unique_ptr<Upload_worker> _worker) :
+            worker{std::move(_worker)} {
+        }
+
+        bool has_worker() const noexcept {
+            return worker != nullptr;
+        }
+
+        // called when `ms` (with `mesh_bounds` and `lods` populated) becomes
+        // the shown model: meshes that are already on the GPU are used as-is.
+        // This is the GPU cache lookup, so it's what counts hits and misses
+        // (uploads are counted separately, in `Streaming_stats`).
+        void adopt(Mesh_gpu_cache& mesh_cache, ModelState& ms) {
+            osim::Mesh_pool const& pool = ms.scene.mesh_pool;
+            ms.gpu_meshes.assign(pool.size(), nullptr);
+            ms.residency.assign(pool.size(), Mesh_residency::pending);
+            for (size_t i = 0; i < pool.size(); ++i) {
+                if (auto it = mesh_cache.meshes.find(pool.ids[i]); it != mesh_cache.meshes.end()) {
+                    ++mesh_cache.hits;
+                    ms.gpu_meshes[i] = it->second;
+                    ms.residency[i] = Mesh_residency::resident;
+                    continue;
+                }
+                ++mesh_cache.misses;
+                if (auto p = proxies.find(pool.ids[i]); p != proxies.end()) {
+                    ms.gpu_meshes[i] = p->second;
+                    ms.residency[i] = Mesh_residency::proxy;
+                }
+            }
+        }
+
+        // integrates finished uploads into the caches and into `ms`. Returns
+        // how many uploads were integrated.
+        size_t collect(App_static_glstate& gls, Mesh_gpu_cache& mesh_cache, ModelState& ms) {
+            size_t rv = 0;
+            if (worker) {
+                for (Upload_result& r : worker->poll()) {
+                    integrate(gls, mesh_cache, ms, r);
+                    ++rv;
+                }
+            }
+            for (Upload_result& r : finished_inline) {
+                integrate(gls, mesh_cache, ms, r);
+                ++rv;
+            }
+            finished_inline.clear();
+            return rv;
+        }
+
+        // dispatches uploads for `ms`'s meshes that aren't resident (or in
+        // flight), most important first, until `budget_bytes` have been
+        // dispatched (at least one upload is dispatched, so that a mesh
+        // bigger than the budget still gets uploaded)
+        void schedule(ModelState const& ms, Visibility const& visible, glm::mat4 const& view_mat, size_t budget_bytes) {
+            osim::Mesh_pool const& pool = ms.scene.mesh_pool;
+
+            // priority = the biggest (approximate) fraction of the screen that
+            // any instance of the mesh covers. Instances that are culled
+            // still count, but much less, so they stream last.
+            std::vector<float> priority(pool.size(), -1.0f);
+            for (size_t i = 0; i < pool.size(); ++i) {
+                if (ms.residency[i] != Mesh_residency::resident and not in_flight.contains(pool.ids[i])) {
+                    priority[i] = 0.0f;
+                }
+            }
+            osim::Scene::Meshes const& meshes = ms.scene.meshes;
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                std::uint32_t pi = meshes.pool_indices[i];
+                if (priority[pi] < 0.0f) {
+                    continue;
+                }
+                glm::mat4 model_mat = glm::scale(meshes.transforms[i], meshes.scales[i]);
+                AABB world = transform_aabb(model_mat, ms.mesh_bounds[pi]);
+                float r = glm::length(world.max - world.min) / 2.0f;
+                float depth = -(view_mat * glm::vec4{aabb_center(world), 1.0f}).z;
+                float coverage = depth > r ? (r / depth) * (r / depth) : 1.0f;
+                if (not visible.meshes[i]) {
+                    coverage *= 0.01f;
+                }
+                priority[pi] = std::max(priority[pi], coverage);
+            }
+
+            std::vector<size_t> order;
+            for (size_t i = 0; i < pool.size(); ++i) {
+                if (priority[i] >= 0.0f) {
+                    order.push_back(i);
+                }
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                bool a_pending = ms.residency[a] == Mesh_residency::pending;
+                bool b_pending = ms.residency[b] == Mesh_residency::pending;
+                if (a_pending != b_pending) {
+                    return a_pending;  // proxies (or small meshes) for everything first
+                }
+                return priority[a] > priority[b];
+            });
+
+            size_t spent = 0;
+            for (size_t i : order) {
+                if (spent > 0 and spent >= budget_bytes) {
+                    break;
+                }
+                // a mesh with no decimated levels (e.g. one that's already
+                // below the LOD triangle threshold) would be its own proxy,
+                // so it's uploaded once, in full
+                Mesh_lods lods = i < ms.lods.size() ? ms.lods[i] : nullptr;
+                bool has_proxy = lods and not lods->empty();
+                Upload_job job{
+                    pool.ids[i],
+                    ms.residency[i] == Mesh_residency::pending and has_proxy,
+                    pool.data[i],
+                    std::move(lods),
+                };
+                spent += job.bytes();
+                in_flight.insert(job.id);
+                if (worker) {
+                    worker->submit(std::move(job));
+                } else {
+                    finished_inline.push_back(run_upload(job));
+                }
+            }
+            bytes_last_frame = spent;
+        }
+
+        // true while `ms` has meshes that aren't resident yet
+        bool busy(ModelState const& ms) const {
+            return not in_flight.empty() or std::any_of(ms.residency.begin(), ms.residency.end(), [](Mesh_residency r) {
+                return r != Mesh_residency::resident;
+            });
+        }
+
+        Streaming_stats stats(ModelState const& ms) const {
+            Streaming_stats rv;
+            for (Mesh_residency r : ms.residency) {
+                switch (r) {
+                case Mesh_residency::pending:
+                    ++rv.pending;
+                    break;
+                case Mesh_residency::proxy:
+                    ++rv.proxy;
+                    break;
+                case Mesh_residency::resident:
+                    ++rv.resident;
+                    break;
+                }
+            }
+            rv.in_flight = in_flight.size();
+            rv.proxy_uploads = proxy_uploads;
+            rv.full_uploads = full_uploads;
+            rv.bytes_uploaded = bytes_uploaded;
+            rv.bytes_last_frame = bytes_last_frame;
+            return rv;
+        }
+    };
+
+    // Lock-free single-producer, single-consumer triple buffer. The producer
+    // fills `write_slot` and `publish`es it, and the consumer `acquire`s the
+    // most recently published slot. Neither side ever waits for the other:
+    // the producer always has a free slot to write, and the consumer always
+    // has a complete value to read (values it doesn't get to are dropped).
+    template<typename T>
+    class Triple_buffer final {
+        // set in `shared` while it holds a value the consumer hasn't seen
+        static constexpr std::uint8_t fresh = 0x4;
+
+        std::array<T, 3> slots{};
+        std::atomic<std::uint8_t> shared{1};  // index of the slot in between
+        std::uint8_t back = 0;                // owned by the producer
+        std::uint8_t front = 2;               // owned by the consumer
+
+    public:
+        T& write_slot() noexcept {
+            return slots[back];
+        }
+
+        void publish() noexcept {
+            back = shared.exchange(back | fresh, std::memory_order_acq_rel) & 0x3;
+        }
+
+        // true if the consumer has acquired everything that was published
+        bool consumed() const noexcept {
+            return (shared.load(std::memory_order_acquire) & fresh) == 0;
+        }
+
+        // makes the most recently published value `read_slot`. Returns false
+        // (and leaves `read_slot` as-is) if nothing new was published.
+        bool acquire() noexcept {
+            if ((shared.load(std::memory_order_relaxed) & fresh) == 0) {
+                return false;
+            }
+            front = shared.exchange(front, std::memory_order_acq_rel) & 0x3;
+            return true;
+        }
+
+        T& read_slot() noexcept {
+            return slots[front];
+        }
+    };
+
+    // One reported state of a running simulation
+    struct Sim_frame {
+        double time = 0.0;
+        double real_time_factor = 0.0;  // sim seconds per wall second, recently
+        std::vector<double> coordinates;
+        osim::Scene scene;
+    };
+
+    enum class Sim_mode : int { realtime, as_fast_as_possible };
+
+    // columns of a trajectory that records `coords`: time, then one per
+    // coordinate, named after it
+    std::vector<std::string> trajectory_columns(std::span<osim::Coordinate_info const> coords) {
+        std::vector<std::string> columns = {"time"};
+        for (osim::Coordinate_info const& c : coords) {
+            columns.push_back(c.name);
+        }
+        return columns;
+    }
+
+    // Runs a forward-dynamic simulation of a model on a background thread,
+    // publishing the scene (body transforms, muscle paths, etc.) for each
+    // reported state through a `Triple_buffer`, so the integrator never waits
+    // on the UI and the UI always draws the latest complete state.
+    //
+    // In `realtime` mode, the simulation is paced to the wall clock (if it
+    // falls behind, it carries on from where it is, rather than catching up).
+    // In `as_fast_as_possible` mode, it isn't paced, and a state's scene is
+    // only extracted if the UI has taken the last one.
+    //
+    // Every reported state's coordinates can also be recorded to a
+    // trajectory file, which `show` can play back (see `Trajectory_player`).
+    class Simulator final {
+        osim::ModelSession session;
+        std::vector<osim::Coordinate_info> coords;
+        double report_interval;
+
+        Triple_buffer<Sim_frame> frames;
+        std::atomic<Sim_mode> mode;
+        std::atomic<bool> stopping = false;
+        std::atomic<bool> failed = false;
+        std::string error_msg;  // written before `failed` is set
+
+        std::unique_ptr<osim::Trajectory_writer> recorder;
+        std::vector<double> record_row;
+
+        std::thread thread;
+
+        void record() {
+            if (not recorder) {
+                return;
+            }
+            record_row.resize(coords.size() + 1);
+            record_row[0] = session.time();
+            for (size_t i = 0; i < coords.size(); ++i) {
+                record_row[i + 1] = session.coordinate_value(i);
+            }
+            recorder->append(record_row);
+        }
+
+        void run() {
+            using Clock = std::chrono::steady_clock;
+            using Seconds = std::chrono::duration<double>;
+
+            try {
+                // wall-clock pacing is relative to this (sim time, wall time)
+                double paced_from = session.time();
+                Clock::time_point paced_from_wall = Clock::now();
+                Sim_mode last_mode = mode.load();
+
+                // real-time factor is measured over ~0.5 s windows
+                double rtf = 0.0;
+                double rtf_from = paced_from;
+                Clock::time_point rtf_from_wall = paced_from_wall;
+
+                record();
+                while (not stopping.load(std::memory_order_relaxed)) {
+                    double t = session.time() + report_interval;
+                    session.integrate_to(t);
+                    record();
+
+                    Clock::time_point now = Clock::now();
+                    Seconds rtf_dt = now - rtf_from_wall;
+                    if (rtf_dt.count() >= 0.5) {
+                        rtf = (t - rtf_from) / rtf_dt.count();
+                        rtf_from = t;
+                        rtf_from_wall = now;
+                    }
+
+                    Sim_mode m = mode.load(std::memory_order_relaxed);
+                    if (m != last_mode) {
+                        paced_from = t;
+                        paced_from_wall = now;
+                        last_mode = m;
+                    }
+
+                    if (m == Sim_mode::realtime) {
+                        auto due = paced_from_wall + std::chrono::duration_cast<Clock::duration>(Seconds{t - paced_from});
+                        if (due > now) {
+                            std::this_thread::sleep_until(due);
+                        } else if (now - due > 100ms) {
+                            // too far behind to catch up: re-base
+                            paced_from = t;
+                            paced_from_wall = now;
+                        }
+                    } else if (not frames.consumed()) {
+                        continue;  // the UI hasn't drawn the last state yet
+                    }
+
+                    Sim_frame& f = frames.write_slot();
+                    f.time = t;
+                    f.real_time_factor = rtf;
+                    f.coordinates.resize(coords.size());
+                    for (size_t i = 0; i < coords.size(); ++i) {
+                        f.coordinates[i] = session.coordinate_value(i);
+                    }
+                    session.scene(f.scene);
+                    frames.publish();
+                }
+            } catch (std::exception const& ex) {
+                error_msg = ex.what();
+                failed.store(true, std::memory_order_release);
+            }
+        }
+
+    public:
+        // takes over `_session` (until `stop`), and simulates from its
+        // current state, reporting every `_report_interval` sim seconds. If
+        // there's a `_recorder` (see `trajectory_columns`), reported states
+        // are appended to it.
+        Simulator(osim::ModelSession&& _session,
+                  Sim_mode _mode,
+                  double _report_interval,
+                  std::unique_ptr<osim::Trajectory_writer> _recorder = nullptr) :
+            session{std::move(_session)},
+            coords(session.coordinates().begin(), session.coordinates().end()),
+            report_interval{_report_interval},
+            mode{_mode},
+            recorder{std::move(_recorder)},
+            thread{[this]() { run(); }} {
+        }
+        Simulator(Simulator const&) = delete;
+        Simulator& operator=(Simulator const&) = delete;
+        ~Simulator() noexcept {
+            stopping = true;
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        // stops the simulation, and returns the session (in the latest
+        // simulated state)
+        osim::ModelSession stop() {
+            stopping = true;
+            thread.join();
+            recorder.reset();  // finishes the file
+            return std::move(session);
+        }
+
+        void set_mode(Sim_mode m) {
+            mode = m;
+        }
+
+        std::span<osim::Coordinate_info const> coordinates() const noexcept {
+            return coords;
+        }
+
+        // makes the latest published state `latest()`. Returns false if no
+        // state has been published since the last call.
+        bool poll() {
+            return frames.acquire();
+        }
+
+        Sim_frame& latest() noexcept {
+            return frames.read_slot();
+        }
+
+        // set (and the simulation stopped) if integration failed
+        std::optional<std::string> error() const {
+            if (failed.load(std::memory_order_acquire)) {
+                return error_msg;
+            }
+            return std::nullopt;
+        }
+    };
+
+    // a file that is deleted when its owner is destroyed (e.g. a motion
+    // that was imported into the temp directory)
+    class Owned_file final {
+        std::filesystem::path p;
+
+    public:
+        Owned_file() = default;
+        explicit Owned_file(std::filesystem::path _p) : p{std::move(_p)} {
+        }
+        Owned_file(Owned_file&& o) noexcept : p{std::exchange(o.p, {})} {
+        }
+        Owned_file& operator=(Owned_file&& o) noexcept {
+            if (this != &o) {
+                reset();
+                p = std::exchange(o.p, {});
+            }
+            return *this;
+        }
+        ~Owned_file() noexcept {
+            reset();
+        }
+
+        void reset() noexcept {
+            if (not p.empty()) {
+                std::error_code ec;
+                std::filesystem::remove(p, ec);
+                p.clear();
+            }
+        }
+    };
+
+    // A recorded motion of the shown model's coordinates: a memory-mapped
+    // trajectory file (see trajectory.hpp), and which of its columns drives
+    // which coordinate
+    struct Motion {
+        std::filesystem::path source;  // what the user loaded
+        Owned_file imported;  // the trajectory file, if `source` was imported; outlives `traj`'s mapping
+        osim::Trajectory traj;
+        std::vector<std::optional<size_t>> columns;  // per model coordinate
+        size_t num_mapped = 0;
+    };
+
+    // the model coordinate that a motion column label refers to, if any.
+    // Labels are either coordinate names (old .mot files, and trajectories
+    // recorded by `show`) or OpenSim 4 state paths, such as
+    // "/jointset/knee_r/knee_angle_r/value".
+    std::optional<size_t> coordinate_for_label(std::string_view label, std::span<osim::Coordinate_info const> coords) {
+        if (label.ends_with("/value")) {
+            label.remove_suffix(std::string_view{"/value"}.size());
+        }
+        if (size_t slash = label.rfind('/'); slash != label.npos) {
+            label.remove_prefix(slash + 1);
+        }
+        for (size_t i = 0; i < coords.size(); ++i) {
+            if (coords[i].name == label) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // converts an OpenSim .mot/.sto motion into a trajectory file (in the
+    // temp directory), so that all motions are played from a mapping. Only
+    // columns that drive one of `coords` are kept, under the coordinate's
+    // name, and angles in degrees are converted to radians.
+    //
+    // Every import gets its own file, so re-importing never truncates one
+    // that a player still has mapped. It is written under a temporary name
+    // and only renamed to the returned path once complete; a failed or
+    // abandoned import deletes it. The caller owns the returned file.
+    //
+    // `progress`, if set, is periodically called with the fraction of the
+    // file that has been read, and can return false to abandon the import
+    // (which then throws).
+    std::filesystem::path import_motion(std::filesystem::path const& path,
+                                        std::span<osim::Coordinate_info const> coords,
+                                        std::function<bool(float)> const& progress = {}) {
+        std::ifstream in{path};
+        if (not in) {
+            throw std::runtime_error{path.string() + ": cannot open"};
+        }
+        auto file_size = static_cast<float>(std::max<std::uintmax_t>(std::filesystem::file_size(path), 1));
+
+        bool in_degrees = false;
+        bool header_ended = false;
+        for (std::string line; std::getline(in, line);) {
+            if (line.starts_with("endheader")) {
+                header_ended = true;
+                break;
+            }
+            std::string lower = line;
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+            lower.erase(std::remove_if(lower.begin(), lower.end(), [](unsigned char c) { return std::isspace(c); }), lower.end());
+            if (lower == "indegrees=yes") {
+                in_degrees = true;
+            }
+        }
+        if (not header_ended) {
+            throw std::runtime_error{path.string() + ": no 'endheader' line: not a .mot/.sto file?"};
+        }
+
+        // column labels are tab-separated (they can contain spaces)
+        std::string labels_line;
+        std::getline(in, labels_line);
+        if (not labels_line.empty() and labels_line.back() == '\r') {
+            labels_line.pop_back();
+        }
+        std::vector<std::string> labels;
+        {
+            char sep = labels_line.find('\t') != labels_line.npos ? '\t' : ' ';
+            std::stringstream ss{labels_line};
+            for (std::string label; std::getline(ss, label, sep);) {
+                if (not label.empty()) {
+                    labels.push_back(label);
+                }
+            }
+        }
+        if (labels.empty() or labels[0] != "time") {
+            throw std::runtime_error{path.string() + ": the first column must be 'time'"};
+        }
+
+        // (motion column, coordinate) pairs that are kept
+        std::vector<std::pair<size_t, size_t>> kept;
+        std::vector<std::string> names = {"time"};
+        for (size_t col = 1; col < labels.size(); ++col) {
+            if (std::optional<size_t> c = coordinate_for_label(labels[col], coords); c) {
+                kept.emplace_back(col, *c);
+                names.push_back(coords[*c].name);
+            }
+        }
+        if (kept.empty()) {
+            throw std::runtime_error{path.string() + ": no columns match the model's coordinates"};
+        }
+
+        // e.g. /tmp/osim-snippets-motion.traj.<pid>-<random>.tmp, renamed to
+        // /tmp/osim-snippets-motion.traj.<pid>-<random>.traj when complete
+        std::filesystem::path tmp = osim::unique_temp_path(std::filesystem::temp_directory_path() / "osim-snippets-motion.traj");
+        std::filesystem::path out = std::filesystem::path{tmp}.replace_extension(".traj");
+        try {
+            // (scoped, so that the file is closed before it's renamed)
+            osim::Trajectory_writer writer{tmp, names};
+            std::vector<double> values;
+            std::vector<double> row(names.size());
+            std::uint64_t rows_read = 0;
+            for (std::string line; std::getline(in, line);) {
+                if (progress and ++rows_read % 1024 == 0) {
+                    if (not progress(static_cast<float>(in.tellg()) / file_size)) {
+                        throw std::runtime_error{path.string() + ": import cancelled"};
+                    }
+                }
+                values.clear();
+                char const* p = line.c_str();
+                for (char* end;; p = end) {
+                    double v = std::strtod(p, &end);
+                    if (end == p) {
+                        break;
+                    }
+                    values.push_back(v);
+                }
+                if (values.empty()) {
+                    continue;  // e.g. trailing blank line
+                }
+                if (values.size() != labels.size()) {
+                    throw std::runtime_error{path.string() + ": row has " + std::to_string(values.size()) + " values, expected " + std::to_string(labels.size())};
+                }
+                row[0] = values[0];
+                for (size_t i = 0; i < kept.size(); ++i) {
+                    double v = values[kept[i].first];
+                    row[i + 1] = in_degrees and coords[kept[i].second].rotational ? v * (M_PI / 180.0) : v;
+                }
+                writer.append(row);
+            }
+            writer.finish();
+        } catch (...) {
+            // the writer's destructor has already closed (and finished) it
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            throw;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, out, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            throw std::runtime_error{out.string() + ": cannot rename the imported motion into place"};
+        }
+        return out;
+    }
+
+    // loads a .traj, .mot or .sto motion for a model with `coords`. Throws if
+    // it can't be loaded, or has nothing to play. `progress` is as for
+    // `import_motion` (.traj files are mapped, so they don't report any).
+    Motion load_motion(std::filesystem::path const& path,
+                       std::span<osim::Coordinate_info const> coords,
+                       std::function<bool(float)> const& progress = {}) {
+        // an imported file is owned by the motion (and so also deleted if
+        // this throws)
+        bool is_traj = path.extension() == ".traj";
+        std::filesystem::path file = is_traj ? path : import_motion(path, coords, progress);
+        Motion m{path, is_traj ? Owned_file{} : Owned_file{file}, osim::Trajectory{file}, {}, 0};
+
+        m.columns.resize(coords.size());
+        for (size_t col = 1; col < m.traj.num_columns(); ++col) {
+            if (std::optional<size_t> c = coordinate_for_label(m.traj.column_names()[col], coords); c) {
+                m.columns[*c] = col;
+                ++m.num_mapped;
+            }
+        }
+        if (m.num_mapped == 0) {
+            throw std::runtime_error{path.string() + ": no columns match the model's coordinates"};
+        }
+        if (m.traj.num_rows() == 0) {
+            throw std::runtime_error{path.string() + ": has no frames"};
+        }
+        return m;
+    }
+
+    bool is_motion_file(std::filesystem::path const& p) {
+        return p.extension() == ".traj" or p.extension() == ".mot" or p.extension() == ".sto";
+    }
+
+    struct Loaded_motion {
+        std::uint64_t generation;
+        std::filesystem::path path;
+        std::optional<Motion> motion;  // empty if loading failed
+        std::string error;
+    };
+
+    // Loads motions (see `load_motion`) on a background thread, because
+    // importing a long .mot/.sto takes seconds. As with `Model_loader`, a
+    // new request supersedes any earlier one.
+    class Motion_loader final {
+    public:
+        struct Progress {
+            bool loading = false;
+            std::filesystem::path path;
+            float done = 0.0f;  // fraction of the file imported (.mot/.sto only)
+        };
+
+    private:
+        struct Request {
+            std::filesystem::path path;
+            std::vector<osim::Coordinate_info> coords;
+        };
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::optional<Request> requested;  // not yet started by the thread
+        std::uint64_t generation = 0;      // of the most recent request
+        std::deque<Loaded_motion> finished;
+        Progress current_progress;
+        bool stopping = false;
+
+        // last, so that it starts after everything it uses is constructed
+        std::thread thread;
+
+        void run() {
+            while (true) {
+                Request req;
+                std::uint64_t gen;
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [&]() { return stopping or requested.has_value(); });
+                    if (stopping) {
+                        return;
+                    }
+                    req = std::move(*requested);
+                    requested.reset();
+                    gen = generation;
+                    current_progress = Progress{true, req.path, 0.0f};
+                }
+
+                // returns false (abandoning the import) if `gen` has been
+                // superseded, or the loader is being destroyed
+                auto report = [&](float done) {
+                    std::lock_guard lock{mutex};
+                    current_progress.done = done;
+                    return gen == generation and not stopping;
+                };
+
+                Loaded_motion loaded{gen, req.path, std::nullopt, {}};
+                try {
+                    loaded.motion = load_motion(req.path, req.coords, report);
+                } catch (std::exception const& ex) {
+                    loaded.error = ex.what();
+                }
+
+                std::lock_guard lock{mutex};
+                finished.push_back(std::move(loaded));
+                if (not requested) {
+                    current_progress = Progress{};
+                }
+            }
+        }
+
+    public:
+        Motion_loader() : thread{[this]() { run(); }} {
+        }
+        Motion_loader(Motion_loader const&) = delete;
+        Motion_loader& operator=(Motion_loader const&) = delete;
+        ~Motion_loader() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            thread.join();
+        }
+
+        // starts loading `path` for a model with `coords` (superseding any
+        // earlier request)
+        void request(std::filesystem::path path, std::span<osim::Coordinate_info const> coords) {
+            {
+                std::lock_guard lock{mutex};
+                requested = Request{std::move(path), {coords.begin(), coords.end()}};
+                ++generation;
+            }
+            cv.notify_all();
+        }
+
+        // drops any request, so that nothing is returned by `poll` until
+        // the next one (e.g. because the model it was for was replaced)
+        void cancel() {
+            std::lock_guard lock{mutex};
+            requested.reset();
+            ++generation;
+        }
+
+        // returns the result of the most recent request, if it has finished
+        // (and hasn't already been returned). Never blocks on loading.
+        std::optional<Loaded_motion> poll() {
+            std::lock_guard lock{mutex};
+            while (not finished.empty() and finished.front().generation != generation) {
+                finished.pop_front();
+            }
+            if (finished.empty()) {
+                return std::nullopt;
+            }
+            Loaded_motion rv = std::move(finished.front());
+            finished.pop_front();
+            return rv;
+        }
+
+        Progress progress() {
+            std::lock_guard lock{mutex};
+            return current_progress;
+        }
+
+        // true if a request is queued, in progress, or waiting to be polled
+        bool busy() {
+            std::lock_guard lock{mutex};
+            return requested.has_value() or current_progress.loading or not finished.empty();
+        }
+    };
+
+    // writes the pose at time `t` into `pose` (one value per coordinate),
+    // interpolating linearly, in coordinate space, between the frames either
+    // side of `t`. Coordinates that the motion doesn't drive are left as-is.
+    void motion_pose(Motion const& m, double t, std::span<double> pose) {
+        osim::Trajectory const& traj = m.traj;
+        std::uint64_t i = traj.find_row(t);
+        std::uint64_t j = std::min(i + 1, traj.num_rows() - 1);
+        double ti = traj.at(i, 0);
+        double tj = traj.at(j, 0);
+        double alpha = tj > ti ? std::clamp((t - ti) / (tj - ti), 0.0, 1.0) : 0.0;
+
+        for (size_t c = 0; c < m.columns.size(); ++c) {
+            if (m.columns[c]) {
+                double a = traj.at(i, *m.columns[c]);
+                double b = traj.at(j, *m.columns[c]);
+                pose[c] = a + alpha * (b - a);
+            }
+        }
+    }
+
+    // Plays a `Motion` on a model, with a worker thread that prefetches
+    // (reads and poses) the frames around the playhead, so scrubbing never
+    // waits on scene extraction.
+    //
+    // Time is quantized into keys, `key_step` (1/120 s of motion) apart,
+    // whatever the recording's frame rate, so a key's scene can be cached.
+    // Keys between recorded frames are interpolated (see `motion_pose`), so
+    // a coarse (e.g. 30 Hz) or slowed-down motion still plays smoothly; a
+    // recording denser than 120 Hz is only shown at 120 Hz. The UI `seek`s
+    // the key under the playhead, and gets its scene if it (or a key just
+    // behind it) has
+    // already been extracted (a hit). On a miss, the UI keeps showing the
+    // last scene, and the worker extracts that key next. Then it fills the
+    // cache outwards from the playhead: ahead, at the keys the playhead
+    // will land on next, and densely just behind it. Keys far from the
+    // playhead are evicted, so memory use doesn't depend on the motion's
+    // length.
+    //
+    // Like `Simulator`, the player takes over the model's session until it
+    // is stopped.
+    class Trajectory_player final {
+    public:
+        static constexpr std::int64_t prefetch_ahead = 64;
+        static constexpr std::int64_t prefetch_behind = 16;
+        static constexpr size_t cache_capacity = prefetch_ahead + prefetch_behind + 16;
+
+        struct Stats {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t extracted = 0;
+            float extract_ms = 0.0f;  // average
+            size_t cached = 0;
+
+            float hit_rate() const {
+                auto n = hits + misses;
+                return n > 0 ? static_cast<float>(hits) / static_cast<float>(n) : 0.0f;
+            }
+        };
+
+    private:
+        osim::ModelSession session;
+        std::vector<osim::Coordinate_info> coords;
+        Motion motion_;
+        std::vector<double> base_pose;  // for coordinates the motion doesn't drive
+        static constexpr double key_step = 1.0 / 120.0;
+        std::int64_t num_keys;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::int64_t playhead = 0;
+        std::int64_t direction = 1;
+        std::int64_t stride = 1;  // keys the playhead moves per frame
+        std::unordered_map<std::int64_t, std::shared_ptr<osim::Scene const>> cache;
+        Stats stats_;
+        double total_extract_ms = 0.0;
+        bool stopping = false;
+        std::string error_msg;
+
+        std::thread thread;
+
+        // true if `k` is one of the keys that are kept prefetched: the keys
+        // that the playhead will land on next (every `stride` keys, in the
+        // direction it's moving), and the keys just behind it (for
+        // scrubbing back). Must hold `mutex`.
+        bool prefetched(std::int64_t k) const {
+            std::int64_t d = (k - playhead) * direction;
+            if (d >= 0) {
+                return d % stride == 0 and d / stride <= prefetch_ahead;
+            }
+            return -d <= prefetch_behind;
+        }
+
+        // the next key to prefetch, if any. Must hold `mutex`.
+        std::optional<std::int64_t> next_key() const {
+            auto wanted = [&](std::int64_t k) {
+                return k >= 0 and k < num_keys and not cache.contains(k);
+            };
+            for (std::int64_t d = 0; d <= prefetch_ahead; ++d) {
+                if (std::int64_t k = playhead + direction * stride * d; wanted(k)) {
+                    return k;
+                }
+                if (d > 0 and d <= prefetch_behind) {
+                    if (std::int64_t k = playhead - direction * d; wanted(k)) {
+                        return k;
+                    }
+                }
+            }
+            return std::nullopt;
+        }
+
+        // drops the cached keys that aren't `prefetched`, farthest from the
+        // playhead first, and only then the farthest prefetched ones (so a
+        // key isn't dropped and then immediately prefetched again). Must
+        // hold `mutex`.
+        void evict() {
+            while (cache.size() > cache_capacity) {
+                auto rank = [&](std::int64_t k) {
+                    return std::pair{not prefetched(k), std::abs(k - playhead)};
+                };
+                auto farthest = std::max_element(cache.begin(), cache.end(), [&](auto const& a, auto const& b) {
+                    return rank(a.first) < rank(b.first);
+                });
+                cache.erase(farthest);
+            }
+        }
+
+        void run() {
+            std::vector<double> pose;
+            std::unique_lock lock{mutex};
+            while (true) {
+                std::optional<std::int64_t> key;
+                cv.wait(lock, [&]() { return stopping or (key = next_key()); });
+                if (stopping) {
+                    return;
+                }
+                lock.unlock();
+
+                auto start = std::chrono::steady_clock::now();
+                auto scene = std::make_shared<osim::Scene>();
+                std::string err;
+                try {
+                    pose = base_pose;
+                    motion_pose(motion_, key_time(*key), pose);
+                    session.set_coordinate_values(pose);
+                    session.scene(*scene);
+                } catch (std::exception const& ex) {
+                    err = ex.what();
+                }
+                double ms = std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start}.count();
+
+                lock.lock();
+                if (not err.empty()) {
+                    error_msg = std::move(err);
+                    return;
+                }
+                cache.emplace(*key, std::move(scene));
+                evict();
+                ++stats_.extracted;
+                total_extract_ms += ms;
+            }
+        }
+
+    public:
+        // takes over `_session` (until `stop`)
+        Trajectory_player(osim::ModelSession&& _session, Motion&& _motion) :
+            session{std::move(_session)},
+            coords(session.coordinates().begin(), session.coordinates().end()),
+            motion_{std::move(_motion)} {
+
+            for (size_t i = 0; i < session.coordinates().size(); ++i) {
+                base_pose.push_back(session.coordinate_value(i));
+            }
+
+            osim::Trajectory const& traj = motion_.traj;
+            double duration = traj.end_time() - traj.start_time();
+            // (the last key is clamped to the end, so the last frame is shown)
+            num_keys = static_cast<std::int64_t>(std::ceil(duration / key_step - 1e-9)) + 1;
+
+            thread = std::thread{[this]() { run(); }};
+        }
+        Trajectory_player(Trajectory_player const&) = delete;
+        Trajectory_player& operator=(Trajectory_player const&) = delete;
+        ~Trajectory_player() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        // stops prefetching, and returns the session, posed at key `k`
+        // (rather than at whichever key was prefetched last)
+        osim::ModelSession stop(std::int64_t k) {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            thread.join();
+
+            try {
+                std::vector<double> pose = base_pose;
+                motion_pose(motion_, key_time(k), pose);
+                session.set_coordinate_values(pose);
+            } catch (std::exception const&) {
+                // the session is still usable, just left at the last
+                // prefetched key
+            }
+            return std::move(session);
+        }
+
+        Motion const& motion() const noexcept {
+            return motion_;
+        }
+
+        std::span<osim::Coordinate_info const> coordinates() const noexcept {
+            return coords;
+        }
+
+        // the session's pose, apart from the coordinates that the motion drives
+        std::span<double const> static_pose() const noexcept {
+            return base_pose;
+        }
+
+        double start_time() const noexcept {
+            return motion_.traj.start_time();
+        }
+
+        double end_time() const noexcept {
+            return motion_.traj.end_time();
+        }
+
+        std::int64_t keys() const noexcept {
+            return num_keys;
+        }
+
+        std::int64_t key_of(double t) const noexcept {
+            auto k = static_cast<std::int64_t>(std::llround((t - start_time()) / key_step));
+            return std::clamp<std::int64_t>(k, 0, num_keys - 1);
+        }
+
+        double key_time(std::int64_t k) const noexcept {
+            return std::min(start_time() + static_cast<double>(k) * key_step, end_time());
+        }
+
+        // time between keys
+        double key_interval() const noexcept {
+            return key_step;
+        }
+
+        struct Frame {
+            std::int64_t key = -1;
+            std::shared_ptr<osim::Scene const> scene;
+        };
+
+        // moves the playhead to key `k`, and returns the scene to show for
+        // it, if there is one yet (otherwise, it's extracted next).
+        // `_stride` is how many keys the playhead moves per frame (1 when
+        // scrubbing), which is what the keys ahead are prefetched at.
+        //
+        // Frame times jitter, so a playhead moving `_stride` keys per frame
+        // doesn't land exactly on the prefetched keys. Any cached key that
+        // is less than `_stride` keys behind `k` is close enough. Each key
+        // that the playhead moves to counts as one hit or miss.
+        Frame seek(std::int64_t k, std::int64_t _stride = 1) {
+            Frame rv;
+            {
+                std::lock_guard lock{mutex};
+                std::int64_t dir = k == playhead ? direction : (k > playhead ? 1 : -1);
+                stride = std::clamp<std::int64_t>(_stride, 1, num_keys);
+                for (std::int64_t d = 0; d < stride; ++d) {
+                    if (auto it = cache.find(k - dir * d); it != cache.end()) {
+                        rv = Frame{it->first, it->second};
+                        break;
+                    }
+                }
+                if (k != playhead) {
+                    direction = dir;
+                    playhead = k;
+                    if (rv.scene) {
+                        ++stats_.hits;
+                    } else {
+                        ++stats_.misses;
+                    }
+                }
+            }
+            cv.notify_all();
+            return rv;
+        }
+
+        // cached keys, for drawing on the timeline
+        void cached_keys(std::vector<std::int64_t>& out) {
+            std::lock_guard lock{mutex};
+            out.clear();
+            for (auto const& [k, scene] : cache) {
+                out.push_back(k);
+            }
+        }
+
+        Stats stats() {
+            std::lock_guard lock{mutex};
+            Stats rv = stats_;
+            rv.cached = cache.size();
+            rv.extract_ms = rv.extracted > 0 ? static_cast<float>(total_extract_ms / static_cast<double>(rv.extracted)) : 0.0f;
+            return rv;
+        }
+
+        // set (and prefetching stopped) if a frame couldn't be extracted
+        std::optional<std::string> error() {
+            std::lock_guard lock{mutex};
+            if (error_msg.empty()) {
+                return std::nullopt;
+            }
+            return error_msg;
+        }
+    };
+
+    // Returns a model matrix that maps the simbody cylinder (see
+    // `simbody_cylinder_triangles`) onto a `line_width`-radius cylinder that
+    // runs from `p1` to `p2`
+    glm::mat4 line_transform(glm::vec3 const& p1, glm::vec3 const& p2, float line_width) {
+        glm::vec3 p1_to_p2 = p2 - p1;
+        float len = glm::length(p1_to_p2);
+        glm::vec3 cylinder_axis = {0.0f, 1.0f, 0.0f};
+        glm::vec3 dir = len > 0.0f ? p1_to_p2/len : cylinder_axis;
+
+        glm::vec3 rotation_axis = glm::cross(cylinder_axis, dir);
+        float cos_angle = glm::clamp(glm::dot(cylinder_axis, dir), -1.0f, 1.0f);
+        glm::mat4 rotation = glm::identity<glm::mat4>();
+        if (glm::length(rotation_axis) > 1e-6f) {
+            rotation = glm::rotate(rotation, glm::acos(cos_angle), glm::normalize(rotation_axis));
+        } else if (cos_angle < 0.0f) {
+            // antiparallel: any perpendicular axis will do
+            rotation = glm::rotate(rotation, pi_f, glm::vec3{1.0f, 0.0f, 0.0f});
+        }
+
+        auto scale_xform = glm::scale(glm::identity<glm::mat4>(), glm::vec3{line_width, len/2.0f, line_width});
+        auto translation = glm::translate(glm::identity<glm::mat4>(), p1 + p1_to_p2/2.0f);
+
+        return translation * rotation * scale_xform;
+    }
+
+    // instance data for the visible (`visible[i] != 0`) cylinders that are
+    // drawn at LOD `level`
+    std::vector<Instance_data> cylinder_instances(osim::Scene::Cylinders const& cs,
+                                                  std::span<std::uint8_t const> visible,
+                                                  std::span<std::uint8_t const> levels,
+                                                  std::uint8_t level) {
+        std::vector<Instance_data> rv;
+        for (size_t i = 0; i < cs.size(); ++i) {
+            if (not visible[i] or levels[i] != level) {
+                continue;
+            }
+            rv.push_back(Instance_data{
+                .model_mat = glm::scale(cs.transforms[i], cs.scales[i]),
+                .rgba = cs.colors[i],
+            });
+        }
+        return rv;
+    }
+
+    // instance data for the visible (`visible[i] != 0`) spheres that are
+    // drawn at LOD `level`
+    std::vector<Instance_data> sphere_instances(osim::Scene::Spheres const& ss,
+                                                std::span<std::uint8_t const> visible,
+                                                std::span<std::uint8_t const> levels,
+                                                std::uint8_t level) {
+        std::vector<Instance_data> rv;
+        for (size_t i = 0; i < ss.size(); ++i) {
+            if (not visible[i] or levels[i] != level) {
+                continue;
+            }
+            float r = ss.radii[i];
+            rv.push_back(Instance_data{
+                .model_mat = glm::scale(ss.transforms[i], glm::vec3{r, r, r}),
+                .rgba = ss.colors[i],
+            });
+        }
+        return rv;
+    }
+
+    // writes instances for the visible (`visible[i] != 0`) lines straight
+    // into `out`, which must have space for all of them
+    void write_line_instances(osim::Scene::Lines const& ls,
+                              std::span<std::uint8_t const> visible,
+                              float line_width,
+                              Instance_data* out) {
+        for (size_t i = 0; i < ls.size(); ++i) {
+            if (not visible[i]) {
+                continue;
+            }
+            *out++ = Instance_data{
+                .model_mat = line_transform(ls.p1s[i], ls.p2s[i], line_width),
+                .rgba = ls.colors[i],
+            };
+        }
+    }
+
+    // Which `Lod_chain` level each element of a scene is drawn at (parallel
+    // to the scene's arrays). Lines are always drawn at full detail.
+    struct Lod_levels {
+        std::vector<std::uint8_t> cylinders;
+        std::vector<std::uint8_t> spheres;
+        std::vector<std::uint8_t> meshes;
+
+        bool operator==(Lod_levels const&) const = default;
+    };
+
+    struct Lod_stats {
+        std::array<size_t, max_lod_levels> objects_per_level{};
+        size_t triangles = 0;               // submitted this frame
+        size_t full_detail_triangles = 0;   // that would be submitted without LOD
+    };
+
+    // Picks, per object, the coarsest level whose error is at most
+    // `threshold_px` pixels once projected onto the screen
+    struct Lod_selector {
+        glm::mat4 view_mat;
+        float px_per_unit;  // pixels per world-space unit at view-space depth 1
+        float threshold_px;
+        bool enabled;
+
+        Lod_selector(glm::mat4 const& _view_mat,
+                     glm::mat4 const& proj_mat,
+                     int viewport_height,
+                     float _threshold_px,
+                     bool _enabled) :
+            view_mat{_view_mat},
+            // proj_mat[1][1] is 1/tan(fovy/2), which maps a unit at depth 1
+            // onto half of the viewport's height (in NDC)
+            px_per_unit{std::abs(proj_mat[1][1]) * static_cast<float>(viewport_height) / 2.0f},
+            threshold_px{_threshold_px},
+            enabled{_enabled} {
+        }
+
+        std::uint8_t select(Lod_chain const& chain, glm::mat4 const& model_mat) const {
+            if (not enabled) {
+                return 0;
+            }
+
+            float scale = std::max({
+                glm::length(glm::vec3{model_mat[0]}),
+                glm::length(glm::vec3{model_mat[1]}),
+                glm::length(glm::vec3{model_mat[2]}),
+            });
+
+            // conservatively use the depth of the nearest point of the
+            // object's bounding sphere
+            float depth = -(view_mat * model_mat[3]).z - scale * chain.radius;
+            if (depth <= 0.0f) {
+                return 0;
+            }
+
+            float px_per_mesh_unit = scale * px_per_unit / depth;
+            for (size_t level = chain.levels.size() - 1; level > 0; --level) {
+                if (chain.errors[level] * px_per_mesh_unit <= threshold_px) {
+                    return static_cast<std::uint8_t>(level);
+                }
+            }
+            return 0;
+        }
+    };
+
+    // selects a level for every visible cylinder, sphere, and mesh in `scene`
+    Lod_stats select_lods(osim::Scene const& scene,
+                          Visibility const& visible,
+                          App_static_glstate& gls,
+                          std::span<std::shared_ptr<Lod_chain> const> gpu_meshes,
+                          Lod_selector const& selector,
+                          Lod_levels& out) {
+        Lod_stats stats;
+        auto count = [&](Lod_chain const& chain, std::uint8_t level) {
+            ++stats.objects_per_level[level];
+            stats.triangles += chain.levels[level].num_triangles();
+            stats.full_detail_triangles += chain.levels.front().num_triangles();
+        };
+
+        osim::Scene::Cylinders const& cs = scene.cylinders;
+        out.cylinders.assign(cs.size(), 0);
+        for (size_t i = 0; i < cs.size(); ++i) {
+            if (visible.cylinders[i]) {
+                out.cylinders[i] = selector.select(gls.cylinder, glm::scale(cs.transforms[i], cs.scales[i]));
+                count(gls.cylinder, out.cylinders[i]);
+            }
+        }
+
+        osim::Scene::Spheres const& ss = scene.spheres;
+        out.spheres.assign(ss.size(), 0);
+        for (size_t i = 0; i < ss.size(); ++i) {
+            if (visible.spheres[i]) {
+                float r = ss.radii[i];
+                out.spheres[i] = selector.select(gls.sphere, glm::scale(ss.transforms[i], glm::vec3{r, r, r}));
+                count(gls.sphere, out.spheres[i]);
+            }
+        }
+
+        osim::Scene::Meshes const& ms = scene.meshes;
+        out.meshes.assign(ms.size(), 0);
+        for (size_t i = 0; i < ms.size(); ++i) {
+            if (visible.meshes[i] and gpu_meshes[ms.pool_indices[i]]) {
+                Lod_chain const& chain = *gpu_meshes[ms.pool_indices[i]];
+                out.meshes[i] = selector.select(chain, glm::scale(ms.transforms[i], ms.scales[i]));
+                count(chain, out.meshes[i]);
+            }
+        }
+
+        size_t line_triangles = gls.cylinder.finest().num_triangles() * static_cast<size_t>(
+            std::count(visible.lines.begin(), visible.lines.end(), 1));
+        stats.triangles += line_triangles;
+        stats.full_detail_triangles += line_triangles;
+
+        return stats;
+    }
+
+    // Sort key of a draw in the render queue. Most-significant bits first:
+    //
+    //     opaque:      [0][program:4][vao:20][depth:24][unused:15]
+    //     transparent: [1][inverted depth:24][program:4][vao:20][unused:15]
+    //
+    // So opaque draws come first, grouped by GL state (and front-to-back
+    // within a group, which helps early-z), then transparent draws come
+    // back-to-front, which blending needs.
+    std::uint64_t sort_key(bool transparent, GLuint program, GLuint vao, float depth, float max_depth) {
+        constexpr std::uint64_t max_d = (std::uint64_t{1} << 24) - 1;
+        float t = std::clamp(depth / max_depth, 0.0f, 1.0f);
+        auto d = static_cast<std::uint64_t>(t * static_cast<float>(max_d));
+        auto prog = static_cast<std::uint64_t>(program & 0xf);
+        auto va = static_cast<std::uint64_t>(vao & 0xfffff);
+
+        if (not transparent) {
+            return (prog << 59) | (va << 39) | (d << 15);
+        }
+        return (std::uint64_t{1} << 63) | ((max_d - d) << 39) | (prog << 35) | (va << 15);
+    }
+
+    struct Sort_entry {
+        std::uint64_t key;
+        std::uint32_t item;
+    };
+
+    // LSD radix sort of `entries` by key, 8 bits per pass. Passes over bytes
+    // that are the same in every key (e.g. the unused low bits) are skipped.
+    void radix_sort(std::vector<Sort_entry>& entries, std::vector<Sort_entry>& scratch) {
+        if (entries.size() <= 1) {
+            return;
+        }
+        scratch.resize(entries.size());
+
+        for (int shift = 0; shift < 64; shift += 8) {
+            std::array<size_t, 256> offsets{};
+            for (Sort_entry const& e : entries) {
+                ++offsets[(e.key >> shift) & 0xff];
+            }
+            if (offsets[(entries.front().key >> shift) & 0xff] == entries.size()) {
+                continue;
+            }
+
+            size_t sum = 0;
+            for (size_t& o : offsets) {
+                size_t count = o;
+                o = sum;
+                sum += count;
+            }
+            for (Sort_entry const& e : entries) {
+                scratch[offsets[(e.key >> shift) & 0xff]++] = e;
+            }
+            entries.swap(scratch);
+        }
+    }
+
+    struct Render_queue_stats {
+        int items = 0;
+        int draws = 0;
+        int vao_binds = 0;
+        int uniform_uploads = 0;
+        int state_changes = 0;  // e.g. toggling depth writes for transparent draws
+
+        int gl_calls() const {
+            return draws + vao_binds + uniform_uploads + state_changes;
+        }
+
+        // GL calls made by drawing each item individually, in scene order
+        // (bind VAO, upload rgba + modelMat, draw, unbind VAO)
+        int naive_gl_calls() const {
+            return 5 * items;
+        }
+    };
+
+    // Collects the frame's individually-drawn items (meshes, and everything
+    // else when instancing is off), sorts them by `sort_key`, and draws them
+    // with GL state changes only where consecutive items differ
+    struct Render_queue {
+        struct Item {
+            Triangle_mesh* mesh;
+            glm::mat4 model_mat;
+            glm::vec4 rgba;
+        };
+
+        std::vector<Item> items;
+        std::vector<Sort_entry> order;
+        std::vector<Sort_entry> scratch;
+        glm::mat4 view_mat;
+        float max_depth = 1.0f;
+
+        // `max_depth` is the view-space depth that sort keys saturate at
+        // (e.g. the far plane)
+        void begin(glm::mat4 const& _view_mat, float _max_depth) {
+            items.clear();
+            order.clear();
+            view_mat = _view_mat;
+            max_depth = _max_depth;
+        }
+
+        void push(Triangle_mesh& mesh, glm::mat4 const& model_mat, glm::vec4 const& rgba) {
+            float depth = -(view_mat * model_mat[3]).z;
+            bool transparent = rgba.a < 1.0f;
+
+            // there is only one non-instanced program, so its ID is always 0
+            order.push_back(Sort_entry{
+                .key = sort_key(transparent, 0, mesh.vao, depth, max_depth),
+                .item = static_cast<std::uint32_t>(items.size()),
+            });
+            items.push_back(Item{&mesh, model_mat, rgba});
+        }
+
+        // draws everything pushed since `begin`. Assumes `gls.program` is
+        // in use and its invariant uniforms are set.
+        Render_queue_stats flush(App_static_glstate& gls) {
+            radix_sort(order, scratch);
+
+            Render_queue_stats stats;
+            stats.items = static_cast<int>(items.size());
+
+            GLuint bound_vao = 0;
+            std::optional<glm::vec4> bound_rgba;
+            bool depth_writes = true;
+            for (Sort_entry const& e : order) {
+                Item& item = items[e.item];
+
+                bool transparent = (e.key >> 63) != 0;
+                if (transparent == depth_writes) {
+                    // transparent items test against, but don't write, depth
+                    glDepthMask(transparent ? GL_FALSE : GL_TRUE);
+                    depth_writes = not transparent;
+                    ++stats.state_changes;
+                }
+
+                GLuint vao = item.mesh->vao;
+                if (vao != bound_vao) {
+                    glBindVertexArray(vao);
+                    bound_vao = vao;
+                    ++stats.vao_binds;
+                }
+
+                if (bound_rgba != item.rgba) {
+                    glglm::Uniform(gls.rgba, item.rgba);
+                    bound_rgba = item.rgba;
+                    ++stats.uniform_uploads;
+                }
+                glglm::Uniform(gls.modelMat, item.model_mat);
+                ++stats.uniform_uploads;
+
+                item.mesh->draw();
+                ++stats.draws;
+            }
+
+            if (not depth_writes) {
+                glDepthMask(GL_TRUE);
+            }
+            gl::BindVertexArray();
+
+            return stats;
+        }
+    };
+
+    // pushes the visible elements of `ms.scene`, at their selected LODs, onto
+    // `queue`. Cylinders, spheres, and lines are only pushed if
+    // `include_primitives` (the instanced path draws them otherwise).
+    void push_scene(Render_queue& queue,
+                    App_static_glstate& gls,
+                    ModelState& ms,
+                    Visibility const& visible,
+                    Lod_levels const& lod_levels,
+                    float line_width,
+                    bool include_primitives) {
+        if (include_primitives) {
+            osim::Scene::Cylinders const& cs = ms.scene.cylinders;
+            for (size_t i = 0; i < cs.size(); ++i) {
+                if (not visible.cylinders[i]) {
+                    continue;
+                }
+                queue.push(gls.cylinder.levels[lod_levels.cylinders[i]], glm::scale(cs.transforms[i], cs.scales[i]), cs.colors[i]);
+            }
+
+            osim::Scene::Spheres const& ss = ms.scene.spheres;
+            for (size_t i = 0; i < ss.size(); ++i) {
+                if (not visible.spheres[i]) {
+                    continue;
+                }
+                float r = ss.radii[i];
+                queue.push(gls.sphere.levels[lod_levels.spheres[i]], glm::scale(ss.transforms[i], glm::vec3{r, r, r}), ss.colors[i]);
+            }
+
+            osim::Scene::Lines const& ls = ms.scene.lines;
+            for (size_t i = 0; i < ls.size(); ++i) {
+                if (not visible.lines[i]) {
+                    continue;
+                }
+                queue.push(gls.cylinder.finest(), line_transform(ls.p1s[i], ls.p2s[i], line_width), ls.colors[i]);
+            }
+        }
+
+        osim::Scene::Meshes const& meshes = ms.scene.meshes;
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            if (not visible.meshes[i]) {
+                continue;
+            }
+            std::uint32_t pi = meshes.pool_indices[i];
+            glm::mat4 model_mat = glm::scale(meshes.transforms[i], meshes.scales[i]);
+            if (not ms.gpu_meshes[pi]) {
+                // not streamed in yet: draw its bounds as a translucent box
+                AABB const& bounds = ms.mesh_bounds[pi];
+                glm::mat4 box_mat = glm::scale(glm::translate(model_mat, aabb_center(bounds)), (bounds.max - bounds.min) / 2.0f);
+                glm::vec4 rgba = meshes.colors[i];
+                rgba.a *= 0.3f;
+                queue.push(gls.box, box_mat, rgba);
+                continue;
+            }
+            Lod_chain& chain = *ms.gpu_meshes[pi];
+            queue.push(chain.levels[lod_levels.meshes[i]], model_mat, meshes.colors[i]);
+        }
+    }
+
+    // A named camera orientation. The orbit camera's angles are applied
+    // (as rotations of the scene) by `orbit_view_matrix`.
+    struct Camera_preset {
+        char const* name;
+        float theta;
+        float phi;
     };
 
-    App_static_glstate initialize() {
+    // assumes models tend to point upwards in Y and forwards in +X (so
+    // sidewards is theta == 0 or PI)
+    constexpr Camera_preset camera_presets[] = {
+        {"front", pi_f/2.0f, 0.0f},
+        {"back", 3.0f * (pi_f/2.0f), 0.0f},
+        {"left", pi_f, 0.0f},
+        {"right", 0.0f, 0.0f},
+        {"top", 0.0f, pi_f/2.0f},
+        {"bottom", 0.0f, 3.0f * (pi_f/2.0f)},
+    };
+
+    // camera: at a fixed position pointing at a fixed origin. The "camera"
+    // works by translating + rotating all objects around that origin.
+    // Rotation is expressed as polar coordinates. Camera panning is
+    // represented as a translation vector.
+    glm::mat4 orbit_view_matrix(float theta, float phi, float radius, glm::vec3 const& pan) {
+        auto rot_theta = glm::rotate(glm::identity<glm::mat4>(), -theta, glm::vec3{ 0.0f, 1.0f, 0.0f });
+        auto theta_vec = glm::normalize(glm::vec3{ sin(theta), 0.0f, cos(theta) });
+        auto phi_axis = glm::cross(theta_vec, glm::vec3{ 0.0, 1.0f, 0.0f });
+        auto rot_phi = glm::rotate(glm::identity<glm::mat4>(), -phi, phi_axis);
+        auto pan_translate = glm::translate(glm::identity<glm::mat4>(), pan);
+        auto camera_pos = glm::vec3(0.0f, 0.0f, radius);
+        return glm::lookAt(camera_pos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3{0.0f, 1.0f, 0.0f}) * rot_theta * rot_phi * pan_translate;
+    }
+
+    // Framebuffer that `render` (and `show`, when it renders at a reduced
+    // resolution) draws into. Multisampled frames are resolved into a
+    // single-sampled framebuffer, which is what is read back (or upscaled).
+    struct Offscreen_target {
+        GLsizei w;
+        GLsizei h;
+        GLsizei samples;
+        gl::Renderbuffer color;  // only used if multisampled
+        gl::Renderbuffer depth;
+        gl::Framebuffer fbo;
+        // single-sampled color: the resolve target if multisampled, or else
+        // `fbo`'s color attachment. It's a texture, so that it can be sampled
+        // (e.g. by the upscale pass).
+        gl::Texture_2d resolved_color;
+        gl::Framebuffer resolved_fbo;
+
+        Offscreen_target(GLsizei _w, GLsizei _h, GLsizei _samples) :
+            w{_w}, h{_h}, samples{_samples} {
+
+            gl::BindTexture(resolved_color);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            gl::BindTexture();
+
+            gl::RenderbufferStorage(depth, samples, GL_DEPTH24_STENCIL8, w, h);
+            gl::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+            if (samples > 1) {
+                gl::RenderbufferStorage(color, samples, GL_RGBA8, w, h);
+                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+            } else {
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resolved_color, 0);
+            }
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+            gl::assert_framebuffer_complete(GL_FRAMEBUFFER, "Offscreen_target");
+
+            if (samples > 1) {
+                gl::BindFramebuffer(GL_FRAMEBUFFER, resolved_fbo);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resolved_color, 0);
+                gl::assert_framebuffer_complete(GL_FRAMEBUFFER, "Offscreen_target (resolve)");
+            }
+            gl::BindFramebuffer();
+        }
+
+        void bind() {
+            gl::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glViewport(0, 0, w, h);
+        }
+
+        // resolves the frame (if multisampled) and returns the framebuffer
+        // that holds it
+        GLuint resolve() {
+            if (samples <= 1) {
+                return fbo;
+            }
+            gl::BindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+            gl::BindFramebuffer(GL_DRAW_FRAMEBUFFER, resolved_fbo);
+            glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            return resolved_fbo;
+        }
+    };
+
+    // Draws an `Offscreen_target`'s (resolved) frame over the whole of the
+    // current framebuffer, bilinearly filtered. This is used instead of a
+    // scaling glBlitFramebuffer because the window's framebuffer is
+    // multisampled, and GL can't blit into a multisampled framebuffer at a
+    // different size.
+    struct Upscale_glstate {
+        gl::Program program;
+        gl::Uniform1i scene;
+        gl::Vertex_array vao;  // empty: core profile can't draw without one
+
+        void draw(Offscreen_target& target) {
+            gl::UseProgram(program);
+            gl::Uniform(scene, 0);
+            glActiveTexture(GL_TEXTURE0);
+            gl::BindTexture(target.resolved_color);
+
+            GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+            GLboolean blend = glIsEnabled(GL_BLEND);
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+            gl::BindVertexArray(vao);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            gl::BindVertexArray();
+
+            if (depth_test) {
+                glEnable(GL_DEPTH_TEST);
+            }
+            if (blend) {
+                glEnable(GL_BLEND);
+            }
+            gl::BindTexture();
+            gl::UseProgram();
+        }
+    };
+
+    Upscale_glstate initialize_upscale() {
         auto program = gl::Program{};
-        auto vertex_shader = gl::Vertex_shader::Compile(vertex_shader_src);
+        auto vertex_shader = gl::Vertex_shader::Compile(upscale_vertex_shader_src);
         gl::AttachShader(program, vertex_shader);
-        auto frag_shader = gl::Fragment_shader::Compile(frag_shader_src);
+        auto frag_shader = gl::Fragment_shader::Compile(upscale_frag_shader_src);
         gl::AttachShader(program, frag_shader);
 
         gl::LinkProgram(program);
 
-        auto projMat = gl::UniformMatrix4fv{program, "projMat"};
-        auto viewMat = gl::UniformMatrix4fv{program, "viewMat"};
-        auto modelMat = gl::UniformMatrix4fv{program, "modelMat"};
-        auto rgba = gl::UniformVec4f{program, "rgba"};
-        auto light_pos = gl::UniformVec3f{program, "lightPos"};
-        auto light_color = gl::UniformVec3f{program, "lightColor"};
-        auto view_pos = gl::UniformVec3f{program, "viewPos"};
-
-        auto in_position = gl::Attribute{program, "location"};
-        auto in_normal = gl::Attribute{program, "in_normal"};
+        auto scene = gl::Uniform1i{program, "scene"};
 
-        return App_static_glstate {
+        return Upscale_glstate{
             .program = std::move(program),
+            .scene = std::move(scene),
+            .vao = gl::Vertex_array{},
+        };
+    }
 
-            .projMat = std::move(projMat),
-            .viewMat = std::move(viewMat),
-            .modelMat = std::move(modelMat),
-            .rgba = std::move(rgba),
-            .light_pos = std::move(light_pos),
-            .light_color = std::move(light_color),
-            .view_pos = std::move(view_pos),
+    // Picks the scale (of the window's resolution) that `show` renders the
+    // 3D scene at, so that frame times track `target_ms`. A frame's cost is
+    // assumed to be roughly proportional to its pixel count (so, to scale^2),
+    // which holds for fill-bound renderers, e.g. llvmpipe.
+    struct Dynamic_resolution {
+        bool enabled = false;
+        float target_ms = 33.0f;
+        float min_scale = 0.25f;
+        float scale = 1.0f;
+
+        // moves `scale` towards the scale that would have hit the target in
+        // a frame that took `frame_ms`
+        void update(float frame_ms) {
+            if (not enabled or frame_ms <= 0.0f) {
+                return;
+            }
 
-            .location = std::move(in_position),
-            .in_normal = std::move(in_normal),
+            // ignore small errors, so that noise doesn't reallocate the FBO
+            float ratio = target_ms / frame_ms;
+            if (ratio > 0.9f and ratio < 1.1f) {
+                return;
+            }
+
+            // only move halfway there (damps oscillation), in 1/32 steps
+            float ideal = scale * std::sqrt(ratio);
+            float next = std::round((scale + 0.5f * (ideal - scale)) * 32.0f) / 32.0f;
+            scale = std::clamp(next, min_scale, 1.0f);
+        }
+
+        // size the scene should be rendered at in a `w`x`h` window
+        std::pair<GLsizei, GLsizei> render_size(GLsizei w, GLsizei h) const {
+            float sc = enabled ? scale : 1.0f;
+            return {
+                std::max(1, static_cast<GLsizei>(std::lround(static_cast<float>(w) * sc))),
+                std::max(1, static_cast<GLsizei>(std::lround(static_cast<float>(h) * sc))),
+            };
+        }
+    };
 
-            .cylinder = gen_cylinder_mesh(in_position, in_normal, 24),
-            .sphere = gen_sphere_mesh(in_position, in_normal),
+    // Per-frame profile of `show`: CPU time per zone (measured with a steady
+    // clock), GPU time per render pass (measured with GL_TIME_ELAPSED
+    // queries), and what was drawn, for the last `history_size` frames.
+    //
+    // GPU timings are read back a few frames late, without stalling: each
+    // frame's queries come from a ring of `gpu_latency` query sets, and are
+    // only read once GL_QUERY_RESULT_AVAILABLE says so. A frame whose results
+    // still aren't available when its set comes round again gets no GPU
+    // timings. Time queries can't nest, so neither can `Gpu_scope`s.
+    class Frame_profiler final {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Cpu_zone { events, update, uniforms, draw, imgui, swap };
+        static constexpr std::array<char const*, 6> cpu_zone_names = {"events", "update", "uniforms", "draw", "imgui", "swap"};
+
+        enum class Gpu_pass { instanced, queue, upscale, imgui };
+        static constexpr std::array<char const*, 4> gpu_pass_names = {"instanced", "queue", "upscale", "imgui"};
+
+        static constexpr size_t history_size = 600;
+        static constexpr size_t gpu_latency = 4;
+
+        struct Counters {
+            int draw_calls = 0;
+            size_t triangles = 0;
+            int state_changes = 0;  // VAO binds, uniform uploads, etc.
         };
-    }
 
-    struct Line {
-        gl::Array_buffer vbo;
-        gl::Vertex_array vao;
-        osim::Line data;
+        struct Frame {
+            std::uint64_t index = 0;
+            float cpu_frame_ms = 0.0f;  // from `frame_begin` to `frame_end`
+            std::array<float, cpu_zone_names.size()> cpu_ms{};
+            std::optional<std::array<float, gpu_pass_names.size()>> gpu_ms;
+            Counters counters;
 
-        Line(gl::Attribute& in_attr, osim::Line const& _data) :
-            data{_data} {
-            Vec3 points[2] = {
-                {_data.p1.x, _data.p1.y, _data.p1.z},
-                {_data.p2.x, _data.p2.y, _data.p2.z},
-            };
-            gl::BindVertexArray(vao);
-            {
-                gl::BindBuffer(vbo);
-                gl::BufferData(vbo, sizeof(points), points, GL_STATIC_DRAW);
-                gl::VertexAttributePointer(in_attr, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
-                gl::EnableVertexAttribArray(in_attr);
+            float gpu_frame_ms() const {
+                return gpu_ms ? std::accumulate(gpu_ms->begin(), gpu_ms->end(), 0.0f) : 0.0f;
+            }
+        };
+
+        // adds its lifetime (or until `stop`) to a CPU zone
+        class Cpu_scope final {
+            Frame_profiler* profiler;
+            Cpu_zone zone;
+            Clock::time_point start = Clock::now();
+        public:
+            Cpu_scope(Frame_profiler& p, Cpu_zone z) : profiler{&p}, zone{z} {
+            }
+            Cpu_scope(Cpu_scope const&) = delete;
+            Cpu_scope& operator=(Cpu_scope const&) = delete;
+            ~Cpu_scope() noexcept {
+                stop();
+            }
+
+            void stop() {
+                if (profiler) {
+                    std::chrono::duration<float, std::milli> dt = Clock::now() - start;
+                    profiler->current.cpu_ms[static_cast<size_t>(zone)] += dt.count();
+                    profiler = nullptr;
+                }
+            }
+        };
+
+        // times its lifetime on the GPU, as a render pass
+        class Gpu_scope final {
+        public:
+            Gpu_scope(Frame_profiler& p, Gpu_pass pass) {
+                Query_set& set = p.query_sets[p.current_set];
+                glBeginQuery(GL_TIME_ELAPSED, set.queries[static_cast<size_t>(pass)]);
+                set.used[static_cast<size_t>(pass)] = true;
+            }
+            Gpu_scope(Gpu_scope const&) = delete;
+            Gpu_scope& operator=(Gpu_scope const&) = delete;
+            ~Gpu_scope() noexcept {
+                glEndQuery(GL_TIME_ELAPSED);
+            }
+        };
+
+    private:
+        struct Query_set {
+            std::array<gl::Query, gpu_pass_names.size()> queries;
+            std::array<bool, gpu_pass_names.size()> used{};
+            std::optional<std::uint64_t> frame;  // whose results are pending
+        };
+
+        std::array<Query_set, gpu_latency> query_sets;
+        size_t current_set = 0;
+
+        Frame current;
+        Clock::time_point frame_start;
+        std::deque<Frame> history;
+        size_t gpu_dropped = 0;
+
+        // reads `set`'s results into its frame's history entry, if they're
+        // available. Returns false if they aren't.
+        bool try_read(Query_set& set) {
+            for (size_t i = 0; i < set.queries.size(); ++i) {
+                if (not set.used[i]) {
+                    continue;
+                }
+                GLint available = GL_FALSE;
+                glGetQueryObjectiv(set.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == GL_FALSE) {
+                    return false;
+                }
+            }
+
+            std::array<float, gpu_pass_names.size()> ms{};
+            for (size_t i = 0; i < set.queries.size(); ++i) {
+                if (set.used[i]) {
+                    GLuint64 ns = 0;
+                    glGetQueryObjectui64v(set.queries[i], GL_QUERY_RESULT, &ns);
+                    ms[i] = static_cast<float>(ns) / 1e6f;
+                }
+            }
+            if (not history.empty() and *set.frame >= history.front().index) {
+                history[*set.frame - history.front().index].gpu_ms = ms;
+            }
+            return true;
+        }
+
+    public:
+        Cpu_scope cpu(Cpu_zone zone) {
+            return Cpu_scope{*this, zone};
+        }
+
+        Gpu_scope gpu(Gpu_pass pass) {
+            return Gpu_scope{*this, pass};
+        }
+
+        // must be called before any GPU pass of a frame. Also picks up any
+        // GPU results of earlier frames that have become available.
+        void frame_begin() {
+            frame_start = Clock::now();
+
+            for (Query_set& set : query_sets) {
+                if (set.frame and try_read(set)) {
+                    set.frame.reset();
+                }
+            }
+
+            Query_set& set = query_sets[current_set];
+            if (set.frame) {
+                ++gpu_dropped;  // still in flight: don't wait for it
+                set.frame.reset();
+            }
+            set.used.fill(false);
+        }
+
+        void frame_end(Counters const& counters) {
+            std::chrono::duration<float, std::milli> dt = Clock::now() - frame_start;
+            current.cpu_frame_ms = dt.count();
+            current.counters = counters;
+
+            query_sets[current_set].frame = current.index;
+            current_set = (current_set + 1) % query_sets.size();
+
+            history.push_back(current);
+            if (history.size() > history_size) {
+                history.pop_front();
+            }
+
+            std::uint64_t next = current.index + 1;
+            current = Frame{};
+            current.index = next;
+        }
+
+        std::deque<Frame> const& frames() const noexcept {
+            return history;
+        }
+
+        size_t num_gpu_dropped() const noexcept {
+            return gpu_dropped;
+        }
+
+        // the most recent GPU frame time that has been read back, if any
+        std::optional<float> latest_gpu_frame_ms() const {
+            for (auto it = history.rbegin(); it != history.rend(); ++it) {
+                if (it->gpu_ms) {
+                    return it->gpu_frame_ms();
+                }
+            }
+            return std::nullopt;
+        }
+
+        // writes the last `n` frames as CSV, with a header row. GPU columns
+        // are empty for frames that have no GPU timings.
+        void write_csv(std::ostream& out, size_t n) const {
+            out << "frame,cpu_frame_ms";
+            for (char const* name : cpu_zone_names) {
+                out << ",cpu_" << name << "_ms";
+            }
+            out << ",gpu_frame_ms";
+            for (char const* name : gpu_pass_names) {
+                out << ",gpu_" << name << "_ms";
+            }
+            out << ",draw_calls,triangles,state_changes\n";
+
+            n = std::min(n, history.size());
+            for (auto it = history.end() - static_cast<std::ptrdiff_t>(n); it != history.end(); ++it) {
+                out << it->index << ',' << it->cpu_frame_ms;
+                for (float ms : it->cpu_ms) {
+                    out << ',' << ms;
+                }
+                if (it->gpu_ms) {
+                    out << ',' << it->gpu_frame_ms();
+                    for (float ms : *it->gpu_ms) {
+                        out << ',' << ms;
+                    }
+                } else {
+                    out << std::string(1 + gpu_pass_names.size(), ',');
+                }
+                out << ',' << it->counters.draw_calls << ',' << it->counters.triangles << ',' << it->counters.state_changes << '\n';
             }
-            gl::BindVertexArray();
         }
     };
 
-    std::tuple<Mesh_point, Mesh_point, Mesh_point> to_mesh_points(osim::Triangle const& t) {
-        glm::vec3 normal = (t.p2 - t.p1) * (t.p3 - t.p1);
-        Vec3 normal_vec3 = Vec3{normal.x, normal.y, normal.z};
+    // UI state of the profiler's overlay window
+    struct Profiler_window {
+        bool open = false;
+        std::array<char, 1024> csv_path = {"osim-profile.csv"};
+        int csv_frames = static_cast<int>(Frame_profiler::history_size);
+        std::string csv_status;
+    };
+
+    // draws `profiler`'s overlay window: rolling frame-time plots, per-zone
+    // timings, counters, and a CSV export of the last N frames
+    void draw_profiler_window(Frame_profiler const& profiler, Profiler_window& w) {
+        ImGui::SetNextWindowSize(ImVec2{420.0f, 0.0f}, ImGuiCond_FirstUseEver);
+        if (not ImGui::Begin("Profiler", &w.open)) {
+            ImGui::End();
+            return;
+        }
+
+        std::deque<Frame_profiler::Frame> const& frames = profiler.frames();
+        if (frames.empty()) {
+            ImGui::Text("no frames yet");
+            ImGui::End();
+            return;
+        }
 
-        return {
-            Mesh_point{Vec3{t.p1.x, t.p1.y, t.p1.z}, normal_vec3},
-            Mesh_point{Vec3{t.p2.x, t.p2.y, t.p2.z}, normal_vec3},
-            Mesh_point{Vec3{t.p3.x, t.p3.y, t.p3.z}, normal_vec3}
+        // timings over the whole history
+        std::vector<float> cpu_ms;
+        std::vector<float> gpu_ms;
+        std::array<float, Frame_profiler::cpu_zone_names.size()> cpu_zone_total{};
+        std::array<float, Frame_profiler::gpu_pass_names.size()> gpu_pass_total{};
+        size_t num_gpu = 0;
+        for (Frame_profiler::Frame const& f : frames) {
+            cpu_ms.push_back(f.cpu_frame_ms);
+            gpu_ms.push_back(f.gpu_frame_ms());
+            for (size_t i = 0; i < cpu_zone_total.size(); ++i) {
+                cpu_zone_total[i] += f.cpu_ms[i];
+            }
+            if (f.gpu_ms) {
+                ++num_gpu;
+                for (size_t i = 0; i < gpu_pass_total.size(); ++i) {
+                    gpu_pass_total[i] += (*f.gpu_ms)[i];
+                }
+            }
+        }
+        auto percentile = [](std::vector<float> v, float p) {
+            auto nth = v.begin() + static_cast<std::ptrdiff_t>(p * static_cast<float>(v.size() - 1));
+            std::nth_element(v.begin(), nth, v.end());
+            return *nth;
         };
-    }
 
-    // TODO: this is hacked together
-    Triangle_mesh make_mesh(gl::Attribute& in_attr, gl::Attribute& in_normal, osim::Mesh const& data) {
-        std::vector<Mesh_point> triangles;
-        triangles.reserve(3*data.triangles.size());
-        for (osim::Triangle const& t : data.triangles) {
-            auto [p1, p2, p3] = to_mesh_points(t);
-            triangles.emplace_back(p1);
-            triangles.emplace_back(p2);
-            triangles.emplace_back(p3);
+        float cpu_max = *std::max_element(cpu_ms.begin(), cpu_ms.end());
+        float gpu_max = *std::max_element(gpu_ms.begin(), gpu_ms.end());
+        {
+            std::stringstream ss;
+            ss << "CPU frame: p50 " << percentile(cpu_ms, 0.5f) << " ms, p95 " << percentile(cpu_ms, 0.95f) << " ms, max " << cpu_max << " ms";
+            ImGui::Text(ss.str().c_str());
+        }
+        ImGui::PlotHistogram("##cpu", cpu_ms.data(), static_cast<int>(cpu_ms.size()), 0, "CPU ms", 0.0f, cpu_max, ImVec2{0.0f, 60.0f});
+        {
+            std::stringstream ss;
+            ss << "GPU frame: max " << gpu_max << " ms (" << profiler.num_gpu_dropped() << " frames without results)";
+            ImGui::Text(ss.str().c_str());
+        }
+        ImGui::PlotHistogram("##gpu", gpu_ms.data(), static_cast<int>(gpu_ms.size()), 0, "GPU ms", 0.0f, gpu_max, ImVec2{0.0f, 60.0f});
+
+        ImGui::NewLine();
+        ImGui::Text("Average per frame:");
+        for (size_t i = 0; i < cpu_zone_total.size(); ++i) {
+            ImGui::Text("  cpu %-10s %8.3f ms", Frame_profiler::cpu_zone_names[i], cpu_zone_total[i] / static_cast<float>(frames.size()));
+        }
+        for (size_t i = 0; i < gpu_pass_total.size(); ++i) {
+            ImGui::Text("  gpu %-10s %8.3f ms", Frame_profiler::gpu_pass_names[i], num_gpu > 0 ? gpu_pass_total[i] / static_cast<float>(num_gpu) : 0.0f);
+        }
+
+        Frame_profiler::Counters const& last = frames.back().counters;
+        ImGui::NewLine();
+        ImGui::Text("Last frame: %d draw calls, %zu triangles, %d state changes", last.draw_calls, last.triangles, last.state_changes);
+
+        ImGui::NewLine();
+        ImGui::InputText("##csv_path", w.csv_path.data(), w.csv_path.size());
+        ImGui::SameLine();
+        if (ImGui::Button("Export CSV")) {
+            std::ofstream out{w.csv_path.data()};
+            if (out) {
+                profiler.write_csv(out, static_cast<size_t>(w.csv_frames));
+            }
+            w.csv_status = out ? "wrote "s + w.csv_path.data() : w.csv_path.data() + ": cannot write"s;
+        }
+        ImGui::SliderInt("frames", &w.csv_frames, 1, static_cast<int>(Frame_profiler::history_size));
+        if (not w.csv_status.empty()) {
+            ImGui::Text("%s", w.csv_status.c_str());
         }
-        return Triangle_mesh{in_attr, in_normal, triangles};
+
+        ImGui::End();
     }
 
-    struct Osim_mesh {
-        osim::Mesh data;
-        Triangle_mesh mesh;
+    // Decides when `show` draws a frame, so that the viewer uses (almost) no
+    // CPU while nothing on screen changes.
+    //
+    // Whatever changes the screen (camera, scene, UI, window) is reported with
+    // `invalidate`, which causes one frame to be drawn, but no sooner than
+    // `min_frame_interval` after the last one. While something animates (e.g.
+    // a model is streaming in), frames are drawn at `animation_fps`.
+    // Otherwise, `wait` sleeps until an event arrives.
+    class Frame_scheduler final {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // why a frame is drawn
+        enum Reason : unsigned {
+            camera = 1u << 0,
+            scene = 1u << 1,
+            ui = 1u << 2,
+            window = 1u << 3,
+            animation = 1u << 4,
+        };
+        static constexpr std::array<char const*, 5> reason_names = {"camera", "scene", "ui", "window", "animation"};
+
+        struct Stats {
+            size_t frames = 0;
+            std::array<size_t, reason_names.size()> frames_by_reason{};
+        };
+
+        Clock::duration min_frame_interval = 8ms;
+        float animation_fps = 60.0f;
+
+    private:
+        unsigned dirty = camera | scene | window;  // the first frame is always drawn
+        int ui_frames = 0;
+        bool animating = false;
+        Clock::time_point last_frame{};
+        Stats stats_;
+
+        // SDL 2.0.12's SDL_WaitEvent polls for events every 1 ms, which keeps
+        // the CPU busy while idle, so `wait` polls by itself instead, backing
+        // off to `max_idle_poll` the longer nothing happens
+        static constexpr auto max_idle_poll = 50ms;
+        std::chrono::milliseconds idle_poll = 1ms;
+
+        // when the next frame should be drawn (max() if no frame is needed)
+        Clock::time_point due() const {
+            Clock::time_point rv = Clock::time_point::max();
+            if (dirty != 0) {
+                rv = last_frame + min_frame_interval;
+            }
+            if (animating) {
+                auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>{1.0f / animation_fps});
+                rv = std::min(rv, last_frame + std::max(period, min_frame_interval));
+            }
+            return rv;
+        }
+
+    public:
+        void invalidate(unsigned reasons) {
+            dirty |= reasons;
+
+            // UI widgets are processed after the scene is drawn, so whatever
+            // they change (e.g. a camera slider) only shows up in the frame
+            // after the one that handles the input
+            if (reasons & ui) {
+                ui_frames = 2;
+            }
+        }
 
-        Osim_mesh(gl::Attribute& in_attr, gl::Attribute& in_normal, osim::Mesh _data) :
-            data{std::move(_data)},
-            mesh{make_mesh(in_attr, in_normal, data)} {
+        void set_animating(bool v) {
+            animating = v;
         }
-    };
 
-    struct ModelState {
-        std::vector<osim::Cylinder> cylinders;
-        std::vector<Line> lines;
-        std::vector<osim::Sphere> spheres;
-        std::vector<Osim_mesh> meshes;
-    };
-
-    ModelState load_model(App_static_glstate& gls, std::string_view path) {
-        ModelState rv;
-        for (osim::Geometry const& g : osim::geometry_in(path)) {
-            std::visit(overloaded {
-                [&](osim::Cylinder const& c) {
-                    rv.cylinders.push_back(c);
-                },
-                [&](osim::Line const& l) {
-                    rv.lines.emplace_back(gls.location, l);
-                },
-                [&](osim::Sphere const& s) {
-                    rv.spheres.push_back(s);
-                },
-                [&](osim::Mesh const& m) {
-                    rv.meshes.emplace_back(gls.location, gls.in_normal, m);
-                }
-            }, g);
+        // waits for the next event, or until a frame is due. Returns false,
+        // without filling `e`, if a frame is due.
+        bool wait(SDL_Event& e) {
+            while (true) {
+                if (SDL_PollEvent(&e) == 1) {
+                    idle_poll = 1ms;
+                    return true;
+                }
+
+                Clock::time_point next = due();
+                Clock::time_point now = Clock::now();
+                if (now >= next) {
+                    return false;
+                } else if (next != Clock::time_point::max()) {
+                    auto timeout = std::chrono::ceil<std::chrono::milliseconds>(next - now);
+                    return SDL_WaitEventTimeout(&e, static_cast<int>(timeout.count())) == 1;
+                } else {
+                    SDL_Delay(static_cast<Uint32>(idle_poll.count()));
+                    idle_poll = std::min(2 * idle_poll, std::chrono::milliseconds{max_idle_poll});
+                }
+            }
         }
-        return rv;
-    }
+
+        bool frame_due() const {
+            return Clock::now() >= due();
+        }
+
+        // must be called after each drawn frame
+        void frame_drawn() {
+            unsigned reasons = dirty | (animating ? animation : 0u);
+            ++stats_.frames;
+            for (size_t i = 0; i < reason_names.size(); ++i) {
+                if (reasons & (1u << i)) {
+                    ++stats_.frames_by_reason[i];
+                }
+            }
+
+            last_frame = Clock::now();
+            idle_poll = 1ms;
+            dirty = --ui_frames > 0 ? ui : 0u;
+            ui_frames = std::max(ui_frames, 0);
+        }
+
+        Stats const& stats() const noexcept {
+            return stats_;
+        }
+    };
 
     struct ScreenDims {
         int w = 0;
@@ -1516,7 +5482,7 @@ namespace examples::imgui {
         return ss.str();
     }
 
-    void show(ui::State& s, std::string file) {
+    void show(ui::State& s, std::vector<std::string> const& files) {
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         OSC_GL_CALL_CHECK(glEnable, GL_DEPTH_TEST);
         OSC_GL_CALL_CHECK(glEnable, GL_BLEND);
@@ -1539,7 +5505,93 @@ namespace examples::imgui {
         App_static_glstate gls = initialize();
 
         // Mutable runtime state
-        ModelState ms = load_model(gls, file);
+        Mesh_gpu_cache mesh_cache;
+        Render_queue render_queue;
+
+        // models are loaded in the background (see `Model_loader`), and are
+        // shown as soon as they have loaded, while their meshes are streamed
+        // onto the GPU (see `Mesh_streamer`). `ms` is the model that is being
+        // shown, which is empty until the first one has loaded.
+        ModelState ms;
+        Model_loader loader;
+        Mesh_streamer streamer{Upload_worker::create(s.window, s.gl)};
+        std::string load_error;
+        float upload_budget_kb = 512.0f;
+        std::array<char, 1024> path_input{};
+
+        // while a simulation runs, it owns the model's session (so
+        // `ms.session` is empty), and `ms.scene` follows its latest state
+        std::unique_ptr<Simulator> simulator;
+        Sim_mode sim_mode = Sim_mode::realtime;
+        float sim_report_hz = 60.0f;
+        std::string sim_error;
+        bool sim_has_frame = false;
+        bool sim_record = false;
+        std::filesystem::path last_recording;
+
+        // a loaded motion (trajectory) is played by `player`, which, like
+        // `simulator`, owns the model's session while it exists. `play_t` is
+        // the playhead, and `shown_key` is the key whose scene is in
+        // `ms.scene`.
+        std::unique_ptr<Trajectory_player> player;
+        Motion_loader motion_loader;
+        std::string motion_error;
+        double play_t = 0.0;
+        bool playing = false;
+        bool loop_playback = true;
+        float play_speed = 1.0f;
+        auto play_tick = std::chrono::steady_clock::now();
+        std::int64_t shown_key = -1;
+        osim::Scene player_scene;
+        std::vector<std::int64_t> cached_keys;
+
+        // poses set by the UI are extracted off-thread (see `Pose_pipeline`).
+        // `pose` is what the coordinate sliders show, which can be ahead of
+        // `ms.scene`.
+        Pose_pipeline pose_pipeline;
+        std::vector<double> pose;
+        auto read_pose = [&]() {
+            pose.clear();
+            for (size_t i = 0; ms.session and i < ms.session->coordinates().size(); ++i) {
+                pose.push_back(ms.session->coordinate_value(i));
+            }
+        };
+
+        auto request_model = [&](std::string path) {
+            loader.request(std::move(path));
+            load_error.clear();
+        };
+        if (auto it = std::find_if_not(files.begin(), files.end(), [](std::string const& f) { return is_motion_file(f); }); it != files.end()) {
+            request_model(*it);
+        }
+
+        // `visible` is recomputed (by culling against the BVH) every frame,
+        // and so is `lod_levels`. Cylinder/sphere instance data is re-packed
+        // whenever either of them, or the pose, changes. Lines (e.g. muscle
+        // paths) are streamed every frame.
+        bool instanced_rendering = true;
+        bool frustum_culling = true;
+        bool lod = true;
+        float lod_threshold_px = 1.0f;
+        Visibility visible;
+        Visibility uploaded_visible;
+        Lod_levels lod_levels;
+        Lod_levels uploaded_lod_levels;
+        bool instances_dirty = true;
+        auto upload_instances = [&]() {
+            Instanced_glstate& igs = gls.instanced;
+            for (size_t level = 0; level < igs.cylinders.size(); ++level) {
+                auto l = static_cast<std::uint8_t>(level);
+                igs.cylinders[level].upload(cylinder_instances(ms.scene.cylinders, visible.cylinders, lod_levels.cylinders, l));
+            }
+            for (size_t level = 0; level < igs.spheres.size(); ++level) {
+                auto l = static_cast<std::uint8_t>(level);
+                igs.spheres[level].upload(sphere_instances(ms.scene.spheres, visible.spheres, lod_levels.spheres, l));
+            }
+            uploaded_visible = visible;
+            uploaded_lod_levels = lod_levels;
+            instances_dirty = false;
+        };
 
         bool wireframe_mode = false;
         sdl::Window_dimensions window_dims = sdl::GetWindowSize(s.window);
@@ -1557,32 +5609,20 @@ namespace examples::imgui {
         bool panning = false;
         glm::vec3 pan = {0.0f, 0.0f, 0.0f};
 
-        // initial pan position is the average center of *some of the* geometry
-        // in the scene, which is found in an extremely dumb way.
-        if (true) {  // auto-centering
-            glm::vec3 middle = {0.0f, 0.0f, 0.0f};
-            unsigned n = 0;
-            auto update_middle = [&](glm::vec3 const& v) {
-                middle = glm::vec3{
-                    (n*middle.x - v.x)/(n+1),
-                    (n*middle.y - v.y)/(n+1),
-                    (n*middle.z - v.z)/(n+1)
-                };
-                ++n;
-            };
+        float bvh_line_width = line_width;
 
-            for (auto const& l : ms.lines) {
-                update_middle(l.data.p1);
-                update_middle(l.data.p2);
-            }
+        // called when a newly-loaded model has been swapped into `ms`
+        auto on_model_ready = [&]() {
+            ms.bvh.build(ms.scene, ms.mesh_bounds, line_width);
+            bvh_line_width = line_width;
+            instances_dirty = true;
+            read_pose();
 
-            for (auto const& p : ms.spheres) {
-                glm::vec3 translation = {p.transform[3][0], p.transform[3][1], p.transform[3][2]};
-                update_middle(translation);
+            // initial pan position is the center of the scene's bounds
+            if (std::optional<AABB> bounds = ms.bvh.bounds(); bounds) {
+                pan = -aabb_center(*bounds);
             }
-
-            pan = middle;
-        }
+        };
 
         auto light_pos = glm::vec3{1.0f, 1.0f, 0.0f};
         float light_color[3] = {0.98f, 0.95f, 0.95f};
@@ -1597,21 +5637,82 @@ namespace examples::imgui {
             OSC_GL_CALL_CHECK(glDisable, GL_FRAMEBUFFER_SRGB);
         }
 
-        auto last_render_timepoint = std::chrono::high_resolution_clock::now();
-        auto min_delay_between_frames = 8ms;
+        // frames are only drawn when something changes (see
+        // `Frame_scheduler`), or while a model is loading/streaming in
+        Frame_scheduler scheduler;
+        Frame_profiler profiler;
+        Profiler_window profiler_window;
+
+        // finishes extracting the poses set by the UI, before something else
+        // (a simulation, or a motion) takes over the session
+        auto settle_pose = [&]() {
+            if (pose_pipeline.wait_idle(ms)) {
+                ms.bvh.refit(ms.scene, ms.mesh_bounds, line_width);
+                instances_dirty = true;
+                scheduler.invalidate(Frame_scheduler::scene);
+            }
+        };
+
+        // hands the session back, posed at the playhead. The scene might
+        // not be showing that pose yet (if it wasn't extracted), in which
+        // case it's extracted like any other pose the UI sets.
+        auto stop_player = [&]() {
+            if (player) {
+                std::int64_t k = player->key_of(play_t);
+                ms.session.emplace(player->stop(k));
+                player.reset();
+                read_pose();
+                if (k != shown_key) {
+                    pose_pipeline.submit(*ms.session, pose);
+                }
+            }
+        };
+        auto open_motion = [&](std::filesystem::path const& path) {
+            motion_error.clear();
+            if (simulator) {
+                motion_error = "stop the simulation before playing a motion";
+                return;
+            }
+            stop_player();
+            if (not ms.session) {
+                motion_error = "load a model before playing a motion";
+                return;
+            }
+            // played once it's loaded (see `motion_loader.poll()`)
+            motion_loader.request(path, ms.session->coordinates());
+        };
+        auto open_file = [&](std::string path) {
+            if (is_motion_file(path)) {
+                open_motion(path);
+            } else {
+                request_model(std::move(path));
+            }
+        };
+
+        // with dynamic resolution on, the scene is drawn into `scaled_target`
+        // (at a fraction of the window's resolution), which is then upscaled
+        // into the window, under the (native-resolution) UI
+        Dynamic_resolution dynres;
+        std::optional<Offscreen_target> scaled_target;
+        Upscale_glstate upscale = initialize_upscale();
+        GLsizei window_samples = 0;
+        glGetIntegerv(GL_SAMPLES, &window_samples);
+        using Zone = Frame_profiler::Cpu_zone;
+        using Pass = Frame_profiler::Gpu_pass;
 
         while (true) {
-            auto rot_theta = glm::rotate(glm::identity<glm::mat4>(), -theta, glm::vec3{ 0.0f, 1.0f, 0.0f });
-            auto theta_vec = glm::normalize(glm::vec3{ sin(theta), 0.0f, cos(theta) });
-            auto phi_axis = glm::cross(theta_vec, glm::vec3{ 0.0, 1.0f, 0.0f });
-            auto rot_phi = glm::rotate(glm::identity<glm::mat4>(), -phi, phi_axis);
-            auto pan_translate = glm::translate(glm::identity<glm::mat4>(), pan);
             float aspect_ratio = static_cast<float>(window_dims.w) / static_cast<float>(window_dims.h);
 
-            // event loop
+            // event loop: sleeps until there is an event or a frame is due
+            bool player_animating = player and (playing or player->key_of(play_t) != shown_key);
+            scheduler.set_animating(loader.busy() or streamer.busy(ms) or simulator != nullptr or pose_pipeline.busy() or player_animating or motion_loader.busy());
             SDL_Event e;
-            SDL_WaitEvent(&e);
-            do {
+            for (bool has_event = scheduler.wait(e); has_event; has_event = SDL_PollEvent(&e) == 1) {
+                auto events_zone = profiler.cpu(Zone::events);
+
+                // any input may change what ImGui shows (e.g. hover states)
+                scheduler.invalidate(Frame_scheduler::ui);
+
                 ImGui_ImplSDL2_ProcessEvent(&e);
                 if (e.type == SDL_QUIT) {
                     return;
@@ -1687,6 +5788,8 @@ namespace examples::imgui {
                     }
 
                     if (dragging or panning) {
+                        scheduler.invalidate(Frame_scheduler::camera);
+
                         // wrap mouse if it hits edges
                         constexpr int edge_width = 5;
                         if (e.motion.x + edge_width > window_dims.w) {
@@ -1702,19 +5805,132 @@ namespace examples::imgui {
                             SDL_WarpMouseInWindow(s.window, e.motion.x, window_dims.h - edge_width);
                         }
                     }
-                } else if (e.type == SDL_WINDOWEVENT) {
-                    window_dims = sdl::GetWindowSize(s.window);
-                    glViewport(0, 0, window_dims.w, window_dims.h);
-                } else if (e.type == SDL_MOUSEWHEEL) {
-                    if (e.wheel.y > 0 and radius >= 0.1f) {
-                        radius *= wheel_sensitivity;
-                    }
-
-                    if (e.wheel.y <= 0 and radius < 100.0f) {
-                        radius /= wheel_sensitivity;
+                } else if (e.type == SDL_WINDOWEVENT) {
+                    window_dims = sdl::GetWindowSize(s.window);
+                    glViewport(0, 0, window_dims.w, window_dims.h);
+                    scheduler.invalidate(Frame_scheduler::window);
+                } else if (e.type == SDL_MOUSEWHEEL) {
+                    scheduler.invalidate(Frame_scheduler::camera);
+
+                    if (e.wheel.y > 0 and radius >= 0.1f) {
+                        radius *= wheel_sensitivity;
+                    }
+
+                    if (e.wheel.y <= 0 and radius < 100.0f) {
+                        radius /= wheel_sensitivity;
+                    }
+                }
+            }
+
+            auto update_zone = profiler.cpu(Zone::update);
+
+            // show newly-loaded models straight away (their meshes are
+            // streamed in afterwards), and pick up finished mesh uploads
+            if (std::optional<Loaded_model> loaded = loader.poll(); loaded) {
+                if (loaded->ms) {
+                    // these may be using the old model's session
+                    pose_pipeline.cancel();
+                    simulator.reset();
+                    player.reset();
+                    motion_loader.cancel();
+                    ms = std::move(*loaded->ms);
+                    streamer.adopt(mesh_cache, ms);
+                    on_model_ready();
+                } else {
+                    load_error = loaded->path + ": " + loaded->error;
+                }
+                scheduler.invalidate(Frame_scheduler::scene);
+            }
+            if (streamer.collect(gls, mesh_cache, ms) > 0) {
+                scheduler.invalidate(Frame_scheduler::scene);
+            }
+
+            if (pose_pipeline.poll(ms)) {
+                ms.bvh.refit(ms.scene, ms.mesh_bounds, line_width);
+                instances_dirty = true;
+                scheduler.invalidate(Frame_scheduler::scene);
+            }
+
+            // start playing a newly-loaded motion, unless something else
+            // (e.g. a simulation) took over the session while it was loading
+            if (std::optional<Loaded_motion> loaded = motion_loader.poll(); loaded) {
+                if (not loaded->motion) {
+                    motion_error = loaded->error;
+                } else if (simulator or player or not ms.session) {
+                    motion_error = loaded->path.string() + ": the model was busy when the motion finished loading";
+                } else {
+                    settle_pose();
+                    player = std::make_unique<Trajectory_player>(std::move(*ms.session), std::move(*loaded->motion));
+                    ms.session.reset();
+                    play_t = player->start_time();
+                    playing = false;
+                    shown_key = -1;
+                }
+                scheduler.invalidate(Frame_scheduler::scene);
+            }
+
+            // show the simulation's latest state (if there's a new one)
+            if (simulator) {
+                if (simulator->poll()) {
+                    replace_scene(ms, simulator->latest().scene);
+                    ms.bvh.refit(ms.scene, ms.mesh_bounds, line_width);
+                    instances_dirty = true;
+                    sim_has_frame = true;
+                    scheduler.invalidate(Frame_scheduler::scene);
+                }
+                if (std::optional<std::string> err = simulator->error(); err) {
+                    sim_error = "simulation failed: " + *err;
+                    ms.session.emplace(simulator->stop());
+                    simulator.reset();
+                    read_pose();
+                }
+            }
+
+            // show the motion's pose under the playhead, as soon as the
+            // player has extracted it
+            if (player) {
+                auto now = std::chrono::steady_clock::now();
+                if (playing) {
+                    play_t += std::chrono::duration<double>{now - play_tick}.count() * play_speed;
+                    if (play_t >= player->end_time()) {
+                        if (loop_playback) {
+                            play_t = player->start_time();
+                        } else {
+                            play_t = player->end_time();
+                            playing = false;
+                        }
+                    }
+                }
+                // keys moved per frame, at this frame's rate
+                std::int64_t stride = 1;
+                if (playing) {
+                    double dt = std::chrono::duration<double>{now - play_tick}.count();
+                    stride = std::max<std::int64_t>(1, std::llround(dt * play_speed / player->key_interval()));
+                }
+                play_tick = now;
+
+                if (std::int64_t k = player->key_of(play_t); k != shown_key) {
+                    Trajectory_player::Frame frame = player->seek(k, stride);
+                    if (frame.scene and frame.key != shown_key) {
+                        // the cached scene stays in the cache, so it's copied
+                        player_scene = *frame.scene;
+                        replace_scene(ms, player_scene);
+                        ms.bvh.refit(ms.scene, ms.mesh_bounds, line_width);
+                        instances_dirty = true;
+                        shown_key = frame.key;
+                        scheduler.invalidate(Frame_scheduler::scene);
                     }
                 }
-            } while (SDL_PollEvent(&e) == 1);
+                if (std::optional<std::string> err = player->error(); err) {
+                    motion_error = "playback failed: " + *err;
+                    stop_player();
+                }
+            }
+
+            if (not scheduler.frame_due()) {
+                continue;
+            }
+            profiler.frame_begin();
 
             if (user_gamma_correction != gamma_correction) {
                 if (user_gamma_correction) {
@@ -1725,95 +5941,149 @@ namespace examples::imgui {
                 gamma_correction = user_gamma_correction;
             }
 
+            auto [render_w, render_h] = dynres.render_size(window_dims.w, window_dims.h);
+            bool scaled = dynres.enabled;
+            if (scaled) {
+                if (not scaled_target or scaled_target->w != render_w or scaled_target->h != render_h) {
+                    scaled_target.reset();  // free the old one first
+                    scaled_target.emplace(render_w, render_h, std::max(window_samples, 1));
+                }
+                scaled_target->bind();
+            } else {
+                scaled_target.reset();
+            }
+
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             glPolygonMode(GL_FRONT_AND_BACK, wireframe_mode ? GL_LINE : GL_FILL);
 
-            gl::UseProgram(gls.program);
+            float far_plane = 100.0f;
+            auto proj_matrix = glm::perspective(fov, aspect_ratio, 0.1f, far_plane);
+            auto view_matrix = orbit_view_matrix(theta, phi, radius, pan);
+            auto view_pos = glm::vec3{radius * sin(theta) * cos(phi), radius * sin(phi), radius * cos(theta) * cos(phi)};
+            auto light_rgb = glm::vec3(light_color[0], light_color[1], light_color[2]);
 
-            // set *invariant* uniforms
-            {
-                auto proj_matrix = glm::perspective(fov, aspect_ratio, 0.1f, 100.0f);
-                // camera: at a fixed position pointing at a fixed origin. The "camera" works by translating +
-                // rotating all objects around that origin. Rotation is expressed as polar coordinates. Camera
-                // panning is represented as a translation vector.
-                auto camera_pos = glm::vec3(0.0f, 0.0f, radius);
-                glglm::Uniform(gls.projMat, proj_matrix);
-                glglm::Uniform(gls.viewMat,
-                               glm::lookAt(camera_pos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3{0.0f, 1.0f, 0.0f}) * rot_theta * rot_phi * pan_translate);
-                glglm::Uniform(gls.light_pos, light_pos);
-                glglm::Uniform(gls.light_color, glm::vec3(light_color[0], light_color[1], light_color[2]));
-                glglm::Uniform(gls.view_pos, glm::vec3{radius * sin(theta) * cos(phi), radius * sin(phi), radius * cos(theta) * cos(phi)});
+            // line bounds depend on `line_width`
+            if (bvh_line_width != line_width) {
+                ms.bvh.refit(ms.scene, ms.mesh_bounds, line_width);
+                bvh_line_width = line_width;
             }
-
-            for (auto const& c : ms.cylinders) {
-                gl::BindVertexArray(gls.cylinder.vao);
-                glglm::Uniform(gls.rgba, c.rgba);
-
-                auto scaler = glm::scale(c.transform, c.scale);
-                glglm::Uniform(gls.modelMat, scaler);
-                glDrawArrays(GL_TRIANGLES, 0, gls.cylinder.num_verts);
-                gl::BindVertexArray();
+            if (frustum_culling) {
+                ms.bvh.cull(ms.scene, proj_matrix * view_matrix, visible);
+            } else {
+                visible.reset(ms.scene, 1);
             }
+            streamer.schedule(ms, visible, view_matrix, static_cast<size_t>(upload_budget_kb * 1024.0f));
+
+            Lod_selector lod_selector{view_matrix, proj_matrix, render_h, lod_threshold_px, lod};
+            Lod_stats lod_stats = select_lods(ms.scene, visible, gls, ms.gpu_meshes, lod_selector, lod_levels);
+            update_zone.stop();
+
+            // draw calls issued this frame, and draw calls that would have
+            // been issued by drawing each instance individually
+            int draw_calls = 0;
+            int draw_calls_saved = 0;
+            int state_changes = 0;
+
+            if (instanced_rendering) {
+                Instanced_glstate& igs = gls.instanced;
+
+                {
+                    auto zone = profiler.cpu(Zone::update);
+                    if (instances_dirty
+                        or visible.cylinders != uploaded_visible.cylinders
+                        or visible.spheres != uploaded_visible.spheres
+                        or lod_levels.cylinders != uploaded_lod_levels.cylinders
+                        or lod_levels.spheres != uploaded_lod_levels.spheres) {
+                        upload_instances();
+                    }
 
-            for (auto const& c : ms.spheres) {
-                gl::BindVertexArray(gls.sphere.vao);
-                glglm::Uniform(gls.rgba, c.rgba);
-                auto scaler = glm::scale(c.transform, glm::vec3{c.radius, c.radius, c.radius});
-                glglm::Uniform(gls.modelMat, scaler);
-                glDrawArrays(GL_TRIANGLES, 0, gls.sphere.num_verts);
-                gl::BindVertexArray();
-            }
+                    auto num_visible_lines = static_cast<size_t>(std::count(visible.lines.begin(), visible.lines.end(), 1));
+                    write_line_instances(ms.scene.lines, visible.lines, line_width, igs.lines.map(num_visible_lines));
+                    igs.lines.unmap();
+                }
 
-            for (auto& l : ms.lines) {
-                gl::BindVertexArray(gls.cylinder.vao);
+                auto pass = profiler.gpu(Pass::instanced);
+                {
+                    auto zone = profiler.cpu(Zone::uniforms);
+                    gl::UseProgram(igs.program);
+                    glglm::Uniform(igs.projMat, proj_matrix);
+                    glglm::Uniform(igs.viewMat, view_matrix);
+                    glglm::Uniform(igs.light_pos, light_pos);
+                    glglm::Uniform(igs.light_color, light_rgb);
+                    glglm::Uniform(igs.view_pos, view_pos);
+                    state_changes += 6;
+                }
 
-                // color
-                glglm::Uniform(gls.rgba, l.data.rgba);
+                auto zone = profiler.cpu(Zone::draw);
+                int instanced_draws = 0;
+                for (Instanced_batch& batch : igs.cylinders) {
+                    instanced_draws += batch.draw();
+                }
+                for (Instanced_batch& batch : igs.spheres) {
+                    instanced_draws += batch.draw();
+                }
+                instanced_draws += igs.lines.draw();
 
-                glm::vec3 p1_to_p2 = l.data.p2 - l.data.p1;
-                glm::vec3 c1_to_c2 = glm::vec3{0.0f, 0.0f, 2.0f};
-                auto rotation =
-                        glm::rotate(glm::identity<glm::mat4>(),
-                                    glm::acos(glm::dot(glm::normalize(c1_to_c2), glm::normalize(p1_to_p2))),
-                                    glm::cross(glm::normalize(c1_to_c2), glm::normalize(p1_to_p2)));
-                float scale = glm::length(p1_to_p2)/glm::length(c1_to_c2);
-                auto scale_xform = glm::scale(glm::identity<glm::mat4>(), glm::vec3{line_width, line_width, scale});
-                auto translation = glm::translate(glm::identity<glm::mat4>(), l.data.p1 + p1_to_p2/2.0f);
+                draw_calls += instanced_draws;
+                draw_calls_saved = static_cast<int>(ms.scene.cylinders.size() + ms.scene.spheres.size() + ms.scene.lines.size()) - instanced_draws;
+                state_changes += instanced_draws;  // one VAO bind per batch
+            }
 
-                glglm::Uniform(gls.modelMat, translation * rotation * scale_xform);
-                glDrawArrays(GL_TRIANGLES, 0, gls.cylinder.num_verts);
+            Render_queue_stats queue_stats;
+            {
+                auto pass = profiler.gpu(Pass::queue);
+                {
+                    auto zone = profiler.cpu(Zone::uniforms);
+                    gl::UseProgram(gls.program);
+
+                    // set *invariant* uniforms
+                    glglm::Uniform(gls.projMat, proj_matrix);
+                    glglm::Uniform(gls.viewMat, view_matrix);
+                    glglm::Uniform(gls.light_pos, light_pos);
+                    glglm::Uniform(gls.light_color, light_rgb);
+                    glglm::Uniform(gls.view_pos, view_pos);
+                    state_changes += 6;
+                }
 
-                gl::BindVertexArray();
-            }
+                auto zone = profiler.cpu(Zone::draw);
+                render_queue.begin(view_matrix, far_plane);
+                push_scene(render_queue, gls, ms, visible, lod_levels, line_width, not instanced_rendering);
+                queue_stats = render_queue.flush(gls);
+                draw_calls += queue_stats.draws;
+                state_changes += queue_stats.vao_binds + queue_stats.uniform_uploads + queue_stats.state_changes;
+
+                // draw lamp
+                if (show_light) {
+                    gl::BindVertexArray(gls.sphere.finest().vao);
+                    glglm::Uniform(gls.rgba, glm::vec4{1.0f, 1.0f, 0.0f, 0.3f});
+                    glglm::Uniform(gls.modelMat, glm::scale(glm::translate(glm::identity<glm::mat4>(), light_pos), {0.05, 0.05, 0.05}));
+                    glDrawArrays(GL_TRIANGLES, 0 , gls.sphere.finest().num_verts);
+                    gl::BindVertexArray();
+                }
 
-            for (auto& m : ms.meshes) {
-                gl::BindVertexArray(m.mesh.vao);
-                glglm::Uniform(gls.rgba, m.data.rgba);
-                auto scaler = glm::scale(m.data.transform, m.data.scale);
-                glglm::Uniform(gls.modelMat, scaler);
-                glDrawArrays(GL_TRIANGLES, 0, m.mesh.num_verts);
-                gl::BindVertexArray();
-            }
+                if (show_unit_cylinder) {
+                    gl::BindVertexArray(gls.cylinder.finest().vao);
+                    glglm::Uniform(gls.rgba, glm::vec4{0.9f, 0.9f, 0.9f, 1.0f});
+                    glglm::Uniform(gls.modelMat, glm::identity<glm::mat4>());
+                    glDrawArrays(GL_TRIANGLES, 0 , gls.cylinder.finest().num_verts);
+                    gl::BindVertexArray();
+                }
 
-            // draw lamp
-            if (show_light) {
-                gl::BindVertexArray(gls.sphere.vao);
-                glglm::Uniform(gls.rgba, glm::vec4{1.0f, 1.0f, 0.0f, 0.3f});
-                glglm::Uniform(gls.modelMat, glm::scale(glm::translate(glm::identity<glm::mat4>(), light_pos), {0.05, 0.05, 0.05}));
-                glDrawArrays(GL_TRIANGLES, 0 , gls.sphere.num_verts);
-                gl::BindVertexArray();
+                gl::UseProgram();
             }
 
-            if (show_unit_cylinder) {
-                gl::BindVertexArray(gls.cylinder.vao);
-                glglm::Uniform(gls.rgba, glm::vec4{0.9f, 0.9f, 0.9f, 1.0f});
-                glglm::Uniform(gls.modelMat, glm::identity<glm::mat4>());
-                glDrawArrays(GL_TRIANGLES, 0 , gls.cylinder.num_verts);
-                gl::BindVertexArray();
+            // upscale the scene into the window: resolve the MSAA samples,
+            // then draw the result as a (filtered) fullscreen texture
+            if (scaled) {
+                auto pass = profiler.gpu(Pass::upscale);
+                auto zone = profiler.cpu(Zone::draw);
+                scaled_target->resolve();
+                gl::BindFramebuffer();
+                glViewport(0, 0, window_dims.w, window_dims.h);
+                upscale.draw(*scaled_target);
             }
 
-            gl::UseProgram();
-
+            auto imgui_zone = profiler.cpu(Zone::imgui);
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplSDL2_NewFrame(s.window);
 
@@ -1822,58 +6092,210 @@ namespace examples::imgui {
             ImGui::Begin("Scene", &b, ImGuiWindowFlags_MenuBar);
 
             {
-                std::stringstream fps;
-                fps << "Fps: " << io.Framerate;
-                ImGui::Text(fps.str().c_str());
+                ImGui::Text("Model: %s", ms.session or simulator or player ? ms.path.c_str() : "(none)");
+
+                Model_loader::Progress progress = loader.progress();
+                if (progress.stage != Model_loader::Stage::idle) {
+                    ImGui::Text("Loading %s: %s", progress.path.c_str(), stage_name(progress.stage));
+                    if (progress.stage == Model_loader::Stage::simplifying and progress.total > 0) {
+                        float frac = static_cast<float>(progress.done) / static_cast<float>(progress.total);
+                        ImGui::ProgressBar(frac, ImVec2{-1.0f, 0.0f});
+                    } else {
+                        // indeterminate: OpenSim doesn't report progress
+                        ImGui::ProgressBar(std::fmod(static_cast<float>(ImGui::GetTime()), 1.0f), ImVec2{-1.0f, 0.0f}, "");
+                    }
+                }
+                if (not load_error.empty()) {
+                    ImGui::TextColored(ImVec4{0.8f, 0.0f, 0.0f, 1.0f}, "%s", load_error.c_str());
+                }
+
+                for (std::string const& f : files) {
+                    if (ImGui::Button(f.c_str())) {
+                        open_file(f);
+                    }
+                }
+                ImGui::InputText("##path", path_input.data(), path_input.size());
+                ImGui::SameLine();
+                if (ImGui::Button("Load") and path_input[0] != '\0') {
+                    open_file(path_input.data());
+                }
+                Streaming_stats streaming = streamer.stats(ms);
+                size_t num_meshes = streaming.pending + streaming.proxy + streaming.resident;
+                if (num_meshes > 0 and streaming.resident < num_meshes) {
+                    float frac = static_cast<float>(streaming.resident) / static_cast<float>(num_meshes);
+                    ImGui::ProgressBar(frac, ImVec2{-1.0f, 0.0f}, (std::to_string(streaming.resident) + "/" + std::to_string(num_meshes) + " meshes resident").c_str());
+                }
+                {
+                    std::stringstream ss;
+                    ss << "Mesh streaming (" << (streamer.has_worker() ? "shared-context worker" : "UI thread") << "): "
+                       << streaming.pending << " pending, " << streaming.proxy << " proxy, " << streaming.resident << " resident, "
+                       << streaming.in_flight << " uploading, " << streaming.proxy_uploads << " proxy + " << streaming.full_uploads << " full uploads, "
+                       << streaming.bytes_uploaded / 1024 << " KiB uploaded ("
+                       << streaming.bytes_last_frame / 1024 << " KiB last frame)";
+                    ImGui::Text(ss.str().c_str());
+                }
+                ImGui::SliderFloat("upload_budget_kb", &upload_budget_kb, 16.0f, 8192.0f);
             }
             ImGui::NewLine();
 
-            ImGui::Text("Camera Position:");
-
+            {
+                if (simulator) {
+                    if (ImGui::Button("Stop simulation")) {
+                        ms.session.emplace(simulator->stop());
+                        simulator.reset();
+                        read_pose();
+                    }
+                } else if (ms.session) {
+                    if (ImGui::Button("Simulate")) {
+                        // start from the latest pose
+                        settle_pose();
+
+                        sim_error.clear();
+                        sim_has_frame = false;
+                        std::unique_ptr<osim::Trajectory_writer> recorder;
+                        if (sim_record) {
+                            std::filesystem::path record_to = std::filesystem::path{ms.path}.stem().string() + ".traj";
+                            try {
+                                recorder = std::make_unique<osim::Trajectory_writer>(record_to, trajectory_columns(ms.session->coordinates()));
+                                last_recording = record_to;
+                            } catch (std::exception const& ex) {
+                                sim_error = ex.what();
+                            }
+                        }
+                        simulator = std::make_unique<Simulator>(std::move(*ms.session), sim_mode, 1.0 / sim_report_hz, std::move(recorder));
+                        ms.session.reset();
+                    }
+                    if (not last_recording.empty()) {
+                        ImGui::SameLine();
+                        if (ImGui::Button(("Play " + last_recording.string()).c_str())) {
+                            open_motion(last_recording);
+                        }
+                    }
+                }
+                if (simulator and sim_has_frame) {
+                    Sim_frame const& f = simulator->latest();
+                    ImGui::SameLine();
+                    ImGui::Text("t = %.3f s, %.2fx real time", f.time, f.real_time_factor);
+                }
+                int mode = static_cast<int>(sim_mode);
+                ImGui::RadioButton("realtime", &mode, static_cast<int>(Sim_mode::realtime));
+                ImGui::SameLine();
+                ImGui::RadioButton("as fast as possible", &mode, static_cast<int>(Sim_mode::as_fast_as_possible));
+                if (mode != static_cast<int>(sim_mode)) {
+                    sim_mode = static_cast<Sim_mode>(mode);
+                    if (simulator) {
+                        simulator->set_mode(sim_mode);
+                    }
+                }
+                if (not simulator) {
+                    ImGui::SliderFloat("sim_report_hz", &sim_report_hz, 10.0f, 1000.0f);
+                    ImGui::Checkbox("record_trajectory", &sim_record);
+                } else if (not last_recording.empty() and sim_record) {
+                    ImGui::Text("recording to %s", last_recording.string().c_str());
+                }
+                if (not sim_error.empty()) {
+                    ImGui::TextColored(ImVec4{0.8f, 0.0f, 0.0f, 1.0f}, "%s", sim_error.c_str());
+                }
+            }
             ImGui::NewLine();
 
-            if (ImGui::Button("Front")) {
-                // assumes models tend to point upwards in Y and forwards in +X
-                theta = pi_f/2.0f;
-                phi = 0.0f;
+            {
+                std::stringstream fps;
+                fps << "Fps: " << io.Framerate;
+                ImGui::Text(fps.str().c_str());
             }
-            ImGui::SameLine();
-            if (ImGui::Button("Back")) {
-                // assumes models tend to point upwards in Y and forwards in +X
-                theta = 3.0f * (pi_f/2.0f);
-                phi = 0.0f;
+            {
+                Frame_scheduler::Stats const& fs = scheduler.stats();
+                std::stringstream frames;
+                frames << "Frames: " << fs.frames << " drawn (";
+                for (size_t i = 0; i < fs.frames_by_reason.size(); ++i) {
+                    frames << (i > 0 ? ", " : "") << Frame_scheduler::reason_names[i] << ' ' << fs.frames_by_reason[i];
+                }
+                frames << ')';
+                ImGui::Text(frames.str().c_str());
             }
-
-            ImGui::SameLine();
-            ImGui::Text("|");
-            ImGui::SameLine();
-
-            if (ImGui::Button("Left")) {
-                // assumes models tend to point upwards in Y and forwards in +X
-                // (so sidewards is theta == 0 or PI)
-                theta = pi_f;
-                phi = 0.0f;
+            ImGui::SliderFloat("animation_fps", &scheduler.animation_fps, 1.0f, 240.0f);
+            ImGui::Checkbox("show_profiler", &profiler_window.open);
+            ImGui::Checkbox("dynamic_resolution", &dynres.enabled);
+            if (dynres.enabled) {
+                ImGui::SameLine();
+                ImGui::Text("%.0f%% (%dx%d)", 100.0f * dynres.scale, render_w, render_h);
+                ImGui::SliderFloat("target_frame_ms", &dynres.target_ms, 4.0f, 100.0f);
+                ImGui::SliderFloat("min_resolution_scale", &dynres.min_scale, 0.25f, 1.0f);
             }
-            ImGui::SameLine();
-            if (ImGui::Button("Right")) {
-                // assumes models tend to point upwards in Y and forwards in +X
-                // (so sidewards is theta == 0 or PI)
-                theta = 0.0f;
-                phi = 0.0f;
+            {
+                std::stringstream calls;
+                calls << "Draw calls: " << draw_calls << " (instancing saved " << draw_calls_saved << ")";
+                ImGui::Text(calls.str().c_str());
+            }
+            ImGui::Checkbox("instanced_rendering", &instanced_rendering);
+            {
+                std::stringstream culling;
+                culling << "Objects: " << visible.drawn << " drawn, " << visible.culled << " culled";
+                ImGui::Text(culling.str().c_str());
+            }
+            ImGui::Checkbox("frustum_culling", &frustum_culling);
+            {
+                std::stringstream lods;
+                lods << "LOD: objects per level:";
+                for (size_t n : lod_stats.objects_per_level) {
+                    lods << ' ' << n;
+                }
+                lods << ", " << lod_stats.triangles << " triangles (" << lod_stats.full_detail_triangles << " at full detail)";
+                ImGui::Text(lods.str().c_str());
+            }
+            ImGui::Checkbox("lod", &lod);
+            ImGui::SliderFloat("lod_threshold_px", &lod_threshold_px, 0.1f, 10.0f);
+            {
+                osim::Mesh_cache_stats cpu = osim::mesh_cache_stats();
+                std::stringstream cache;
+                cache << "Mesh cache: " << cpu.entries << " meshes, "
+                      << cpu.hits << " hits / " << cpu.disk_hits << " disk hits / " << cpu.misses << " misses (CPU), "
+                      << mesh_cache.hits << " hits / " << mesh_cache.misses << " misses (GPU)";
+                ImGui::Text(cache.str().c_str());
             }
+            {
+                std::stringstream queue;
+                queue << "Render queue: " << queue_stats.items << " items, "
+                      << queue_stats.vao_binds << " VAO binds, "
+                      << queue_stats.uniform_uploads << " uniform uploads, "
+                      << queue_stats.gl_calls() << " GL calls (unsorted: " << queue_stats.naive_gl_calls() << ")";
+                ImGui::Text(queue.str().c_str());
+            }
+            {
+                gl::Stream_buffer const& lines = gls.instanced.lines.instances;
+                std::stringstream stream;
+                stream << "Line stream: " << (lines.is_persistent() ? "persistent-mapped" : "orphaned")
+                       << " ring, " << lines.num_waits() << " GPU waits";
+                ImGui::Text(stream.str().c_str());
+            }
+            if (player) {
+                Trajectory_player::Stats ps = player->stats();
+                ImGui::Text("Trajectory prefetch: %.1f%% hit rate (%llu hits, %llu misses)",
+                            100.0f * ps.hit_rate(), static_cast<unsigned long long>(ps.hits), static_cast<unsigned long long>(ps.misses));
+            }
+            ImGui::NewLine();
 
-            ImGui::SameLine();
-            ImGui::Text("|");
-            ImGui::SameLine();
+            ImGui::Text("Camera Position:");
 
-            if (ImGui::Button("Top")) {
-                theta = 0.0f;
-                phi = pi_f/2.0f;
-            }
-            ImGui::SameLine();
-            if (ImGui::Button("Bottom")) {
-                theta = 0.0f;
-                phi = 3.0f * (pi_f/2.0f);
+            ImGui::NewLine();
+
+            for (size_t i = 0; i < std::size(camera_presets); ++i) {
+                Camera_preset const& preset = camera_presets[i];
+                if (i > 0) {
+                    ImGui::SameLine();
+                }
+                if (i > 0 and i % 2 == 0) {
+                    // presets come in opposing pairs
+                    ImGui::Text("|");
+                    ImGui::SameLine();
+                }
+                std::string label = preset.name;
+                label[0] = static_cast<char>(std::toupper(label[0]));
+                if (ImGui::Button(label.c_str())) {
+                    theta = preset.theta;
+                    phi = preset.phi;
+                }
             }
 
             ImGui::NewLine();
@@ -1908,30 +6330,681 @@ namespace examples::imgui {
 
             ImGui::End();
 
+            ImGui::Begin("Coordinates");
+            {
+                bool pose_changed = false;
+                std::span<osim::Coordinate_info const> coords;
+                if (ms.session and pose.size() == ms.session->coordinates().size()) {
+                    coords = ms.session->coordinates();
+                } else if (simulator and sim_has_frame) {
+                    // read-only while simulating
+                    std::vector<double> const& values = simulator->latest().coordinates;
+                    for (size_t i = 0; i < simulator->coordinates().size() and i < values.size(); ++i) {
+                        ImGui::Text("%s: %.4f", simulator->coordinates()[i].name.c_str(), values[i]);
+                    }
+                } else if (player) {
+                    // read-only while playing: the (interpolated) pose under
+                    // the playhead
+                    std::vector<double> values(player->static_pose().begin(), player->static_pose().end());
+                    motion_pose(player->motion(), player->key_time(player->key_of(play_t)), values);
+                    for (size_t i = 0; i < player->coordinates().size(); ++i) {
+                        ImGui::Text("%s: %.4f", player->coordinates()[i].name.c_str(), values[i]);
+                    }
+                }
+                for (size_t i = 0; i < coords.size(); ++i) {
+                    auto v = static_cast<float>(pose[i]);
+                    auto min = static_cast<float>(coords[i].min);
+                    auto max = static_cast<float>(coords[i].max);
+                    if (ImGui::SliderFloat(coords[i].name.c_str(), &v, min, max)) {
+                        pose[i] = v;
+                        pose_changed = true;
+                    }
+                }
+
+                if (pose_changed) {
+                    pose_pipeline.submit(*ms.session, pose);
+                }
+
+                if (std::string err = pose_pipeline.last_error(); not err.empty()) {
+                    ImGui::TextColored(ImVec4{0.8f, 0.0f, 0.0f, 1.0f}, "%s", err.c_str());
+                }
+                if (std::deque<Pose_latency> const& ls = pose_pipeline.latencies(); not ls.empty()) {
+                    Pose_latency avg;
+                    float max_total = 0.0f;
+                    for (Pose_latency const& l : ls) {
+                        avg.queued_ms += l.queued_ms;
+                        avg.extract_ms += l.extract_ms;
+                        avg.handoff_ms += l.handoff_ms;
+                        avg.present_ms += l.present_ms;
+                        max_total = std::max(max_total, l.total_ms());
+                    }
+                    auto n = static_cast<float>(ls.size());
+                    ImGui::NewLine();
+                    ImGui::Text("Pose latency (avg of last %zu, ms): queued %.2f, extract %.2f, handoff %.2f, present %.2f",
+                                ls.size(), avg.queued_ms / n, avg.extract_ms / n, avg.handoff_ms / n, avg.present_ms / n);
+                    ImGui::Text("  total %.2f avg, %.2f max", avg.total_ms() / n, max_total);
+                }
+            }
+            ImGui::End();
+
+            ImGui::Begin("Trajectory");
+            if (player) {
+                Motion const& motion = player->motion();
+                ImGui::Text("%s: %llu frames, %.3f to %.3f s, %zu coordinates driven",
+                            motion.source.string().c_str(),
+                            static_cast<unsigned long long>(motion.traj.num_rows()),
+                            player->start_time(),
+                            player->end_time(),
+                            motion.num_mapped);
+
+                if (ImGui::Button(playing ? "Pause" : "Play")) {
+                    playing = not playing;
+                    play_tick = std::chrono::steady_clock::now();
+                    if (playing and play_t >= player->end_time()) {
+                        play_t = player->start_time();
+                    }
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Close")) {
+                    stop_player();
+                }
+                ImGui::SameLine();
+                ImGui::Checkbox("loop", &loop_playback);
+            }
+            if (player) {
+                ImGui::SliderFloat("speed", &play_speed, 0.05f, 4.0f);
+
+                // timeline: scrubbing moves the playhead, and the strip
+                // under it shows which keys are prefetched
+                ImGui::SetNextItemWidth(-1.0f);
+                auto t = static_cast<float>(play_t);
+                if (ImGui::SliderFloat("##timeline", &t, static_cast<float>(player->start_time()), static_cast<float>(player->end_time()), "%.3f s")) {
+                    play_t = t;
+                }
+                {
+                    ImDrawList* dl = ImGui::GetWindowDrawList();
+                    ImVec2 p = ImGui::GetCursorScreenPos();
+                    float w = ImGui::GetContentRegionAvail().x;
+                    float h = 6.0f;
+                    float last_key = static_cast<float>(std::max<std::int64_t>(player->keys() - 1, 1));
+                    auto key_x = [&](std::int64_t k) {
+                        return p.x + w * static_cast<float>(k) / last_key;
+                    };
+                    dl->AddRectFilled(p, ImVec2{p.x + w, p.y + h}, IM_COL32(210, 210, 210, 255));
+                    player->cached_keys(cached_keys);
+                    for (std::int64_t k : cached_keys) {
+                        dl->AddLine(ImVec2{key_x(k), p.y}, ImVec2{key_x(k), p.y + h}, IM_COL32(60, 160, 60, 255));
+                    }
+                    float x = key_x(player->key_of(play_t));
+                    dl->AddLine(ImVec2{x, p.y - 1.0f}, ImVec2{x, p.y + h + 1.0f}, IM_COL32(200, 30, 30, 255), 2.0f);
+                    ImGui::Dummy(ImVec2{w, h});
+                }
+
+                Trajectory_player::Stats ps = player->stats();
+                ImGui::Text("Prefetch: %.1f%% hit rate (%llu hits, %llu misses), %zu keys cached, %llu extracted (%.2f ms each)",
+                            100.0f * ps.hit_rate(),
+                            static_cast<unsigned long long>(ps.hits),
+                            static_cast<unsigned long long>(ps.misses),
+                            ps.cached,
+                            static_cast<unsigned long long>(ps.extracted),
+                            ps.extract_ms);
+            } else if (Motion_loader::Progress progress = motion_loader.progress(); progress.loading) {
+                ImGui::Text("Loading %s", progress.path.string().c_str());
+                if (progress.done > 0.0f) {
+                    ImGui::ProgressBar(progress.done, ImVec2{-1.0f, 0.0f});
+                } else {
+                    // indeterminate: e.g. mapping a .traj, or a short import
+                    ImGui::ProgressBar(std::fmod(static_cast<float>(ImGui::GetTime()), 1.0f), ImVec2{-1.0f, 0.0f}, "");
+                }
+            } else {
+                ImGui::Text("Load a .traj, .mot or .sto motion (in the Scene window) to play it");
+            }
+            if (not motion_error.empty()) {
+                ImGui::TextColored(ImVec4{0.8f, 0.0f, 0.0f, 1.0f}, "%s", motion_error.c_str());
+            }
+            ImGui::End();
+
+            if (profiler_window.open) {
+                draw_profiler_window(profiler, profiler_window);
+            }
+
             ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            {
+                auto pass = profiler.gpu(Pass::imgui);
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            }
+            imgui_zone.stop();
+
+            // draw. The frame rate is capped by `Frame_scheduler`, rather
+            // than by VSYNC, because VSYNC makes the entire application feel
+            // *very* laggy.
+            {
+                auto zone = profiler.cpu(Zone::swap);
+                SDL_GL_SwapWindow(s.window);
+            }
+            pose_pipeline.frame_presented();
+            profiler.frame_end({draw_calls, lod_stats.triangles, state_changes});
+            scheduler.frame_drawn();
+
+            // GPU timings arrive a few frames late, and don't include CPU
+            // rasterization (e.g. llvmpipe) that happens at swap time, so
+            // follow whichever is worse
+            dynres.update(std::max(profiler.frames().back().cpu_frame_ms, profiler.latest_gpu_frame_ms().value_or(0.0f)));
+        }
+    }
+
+    // An RGBA8 frame that has been read back from the GPU. Rows are
+    // bottom-up, as glReadPixels returns them.
+    struct Frame {
+        std::filesystem::path path;  // where it should be written
+        int w = 0;
+        int h = 0;
+        std::vector<std::uint8_t> rgba;
+    };
+
+    // Asynchronous glReadPixels. Each frame is read into the next of
+    // `num_slots` pixel-pack buffers, which returns immediately, and is only
+    // mapped (which waits for the GPU) once a later frame has been queued
+    // behind it. So the CPU renders frame N+1 while the GPU finishes frame N.
+    class Readback_ring {
+        static constexpr int num_slots = 2;
+
+        struct Slot {
+            gl::Pixel_pack_buffer pbo;
+            GLsync fence = nullptr;
+            Frame frame;  // pixels are empty until the frame is completed
+        };
+
+        Slot slots[num_slots];
+        int next = 0;
+        int w;
+        int h;
+
+        Frame complete(Slot& slot) {
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            size_t bytes = 4 * static_cast<size_t>(w) * static_cast<size_t>(h);
+            gl::BindBuffer(slot.pbo);
+            void const* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+            if (mapped == nullptr) {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                throw std::runtime_error{"Readback_ring: glMapBufferRange failed"};
+            }
+            Frame rv = std::move(slot.frame);
+            rv.rgba.assign(static_cast<std::uint8_t const*>(mapped), static_cast<std::uint8_t const*>(mapped) + bytes);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            return rv;
+        }
+
+    public:
+        Readback_ring(int _w, int _h) : w{_w}, h{_h} {
+            for (Slot& slot : slots) {
+                gl::BindBuffer(slot.pbo);
+                glBufferData(GL_PIXEL_PACK_BUFFER, 4 * static_cast<GLsizeiptr>(w) * h, nullptr, GL_STREAM_READ);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        Readback_ring(Readback_ring const&) = delete;
+        Readback_ring& operator=(Readback_ring const&) = delete;
+        ~Readback_ring() noexcept {
+            for (Slot& slot : slots) {
+                if (slot.fence != nullptr) {
+                    glDeleteSync(slot.fence);
+                }
+            }
+        }
+
+        // queues a read of `fbo`'s frame, which should be written to `path`.
+        // Returns the frame that was queued `num_slots` reads ago, if any.
+        std::optional<Frame> read(GLuint fbo, std::filesystem::path path) {
+            Slot& slot = slots[next];
+            next = (next + 1) % num_slots;
+
+            std::optional<Frame> rv;
+            if (slot.fence != nullptr) {
+                rv = complete(slot);
+            }
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+            gl::BindBuffer(slot.pbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            slot.frame = Frame{std::move(path), w, h, {}};
+
+            return rv;
+        }
+
+        // completes every queued read, oldest first
+        std::vector<Frame> drain() {
+            std::vector<Frame> rv;
+            for (int i = 0; i < num_slots; ++i) {
+                Slot& slot = slots[(next + i) % num_slots];
+                if (slot.fence != nullptr) {
+                    rv.push_back(complete(slot));
+                }
+            }
+            return rv;
+        }
+    };
+
+    enum class Image_format { png, ppm };
+
+    std::uint32_t crc32(std::uint8_t const* data, size_t n, std::uint32_t crc = 0) {
+        static std::array<std::uint32_t, 256> const table = []() {
+            std::array<std::uint32_t, 256> t{};
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < n; ++i) {
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void put_be32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+        out.push_back(static_cast<std::uint8_t>(v >> 24));
+        out.push_back(static_cast<std::uint8_t>(v >> 16));
+        out.push_back(static_cast<std::uint8_t>(v >> 8));
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    // top-down RGB rows (alpha dropped), which is what both formats store
+    std::vector<std::uint8_t> top_down_rgb(Frame const& f) {
+        std::vector<std::uint8_t> rv;
+        rv.reserve(3 * static_cast<size_t>(f.w) * static_cast<size_t>(f.h));
+        for (int y = f.h - 1; y >= 0; --y) {
+            std::uint8_t const* row = f.rgba.data() + 4 * static_cast<size_t>(y) * static_cast<size_t>(f.w);
+            for (int x = 0; x < f.w; ++x) {
+                rv.insert(rv.end(), row + 4*x, row + 4*x + 3);
+            }
+        }
+        return rv;
+    }
+
+    // Encodes an 8-bit RGB PNG. The image data is zlib-wrapped with
+    // uncompressed ("stored") deflate blocks: files are bigger than they
+    // would be with real compression, but encoding is as cheap as a memcpy,
+    // which matters more when writing thousands of thumbnails.
+    std::vector<std::uint8_t> encode_png(Frame const& f) {
+        std::vector<std::uint8_t> rgb = top_down_rgb(f);
+        size_t row_bytes = 3 * static_cast<size_t>(f.w);
+
+        // each row is prefixed by its filter type (0 = none)
+        std::vector<std::uint8_t> raw;
+        raw.reserve((row_bytes + 1) * static_cast<size_t>(f.h));
+        for (int y = 0; y < f.h; ++y) {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgb.begin() + static_cast<std::ptrdiff_t>(y * row_bytes), rgb.begin() + static_cast<std::ptrdiff_t>((y + 1) * row_bytes));
+        }
+
+        std::vector<std::uint8_t> zlib = {0x78, 0x01};
+        std::uint32_t adler_a = 1;
+        std::uint32_t adler_b = 0;
+        for (std::uint8_t byte : raw) {
+            adler_a = (adler_a + byte) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        size_t pos = 0;
+        do {
+            size_t len = std::min<size_t>(raw.size() - pos, 65535);
+            bool last = pos + len == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back(static_cast<std::uint8_t>(len));
+            zlib.push_back(static_cast<std::uint8_t>(len >> 8));
+            zlib.push_back(static_cast<std::uint8_t>(~len));
+            zlib.push_back(static_cast<std::uint8_t>(~len >> 8));
+            zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(pos), raw.begin() + static_cast<std::ptrdiff_t>(pos + len));
+            pos += len;
+        } while (pos < raw.size());
+        put_be32(zlib, (adler_b << 16) | adler_a);
+
+        std::vector<std::uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        auto chunk = [&](char const type[4], std::vector<std::uint8_t> const& data) {
+            put_be32(out, static_cast<std::uint32_t>(data.size()));
+            size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            put_be32(out, crc32(out.data() + start, out.size() - start));
+        };
+
+        std::vector<std::uint8_t> ihdr;
+        put_be32(ihdr, static_cast<std::uint32_t>(f.w));
+        put_be32(ihdr, static_cast<std::uint32_t>(f.h));
+        ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});  // 8-bit, RGB, deflate, no filter, no interlace
+        chunk("IHDR", ihdr);
+        chunk("IDAT", zlib);
+        chunk("IEND", {});
+
+        return out;
+    }
+
+    void write_frame(Frame const& f, Image_format format) {
+        std::ofstream out{f.path, std::ios::binary | std::ios::trunc};
+        if (not out) {
+            throw std::runtime_error{f.path.string() + ": cannot open for writing"};
+        }
+
+        if (format == Image_format::png) {
+            std::vector<std::uint8_t> png = encode_png(f);
+            out.write(reinterpret_cast<char const*>(png.data()), static_cast<std::streamsize>(png.size()));
+        } else {
+            std::vector<std::uint8_t> rgb = top_down_rgb(f);
+            out << "P6\n" << f.w << ' ' << f.h << "\n255\n";
+            out.write(reinterpret_cast<char const*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        }
+
+        if (not out) {
+            throw std::runtime_error{f.path.string() + ": write failed"};
+        }
+    }
+
+    struct Render_options {
+        std::vector<std::filesystem::path> models;
+        std::vector<Camera_preset> views;
+        std::filesystem::path out_dir = ".";
+        int w = 256;
+        int h = 256;
+        int samples = 4;
+        Image_format format = Image_format::png;
+    };
+
+    struct Render_stats {
+        size_t models = 0;
+        size_t frames = 0;
+        size_t failures = 0;
+        double total_s = 0.0;
+        double extract_wait_s = 0.0;  // GL thread blocked on model extraction
+        double render_s = 0.0;        // uploads + draws + queueing readbacks
+        double write_wait_s = 0.0;    // GL thread blocked on image writing
+    };
+
+    // Renders every model in `opts` from every view, and writes the frames as
+    // images. The work is pipelined in three stages, so that each one
+    // overlaps the others:
+    //
+    // - a worker thread extracts model N+1's scene (loading the model,
+    //   realizing its state, loading meshes)
+    // - the GL thread uploads model N's meshes, draws its views, and queues
+    //   their readbacks (see `Readback_ring`)
+    // - a writer thread encodes + writes frames as they are read back
+    Render_stats render(ui::Headless_state&, Render_options const& opts) {
+        using clock = std::chrono::steady_clock;
+        auto seconds_since = [](clock::time_point t) {
+            return std::chrono::duration<double>(clock::now() - t).count();
+        };
+
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        App_static_glstate gls = initialize();
+        Mesh_gpu_cache mesh_cache;
+        Render_queue render_queue;
+        Offscreen_target target{opts.w, opts.h, opts.samples};
+        Readback_ring readback{opts.w, opts.h};
+
+        Render_stats stats;
+        auto start = clock::now();
+
+        std::future<void> writing;
+        auto write_async = [&](Frame f) {
+            auto t = clock::now();
+            if (writing.valid()) {
+                try {
+                    writing.get();
+                } catch (std::exception const& ex) {
+                    std::cerr << "render: " << ex.what() << std::endl;
+                    ++stats.failures;
+                }
+            }
+            stats.write_wait_s += seconds_since(t);
+            writing = std::async(std::launch::async, [f = std::move(f), format = opts.format]() {
+                write_frame(f, format);
+            });
+            ++stats.frames;
+        };
+
+        auto extract = [](std::filesystem::path path) {
+            auto ms = std::make_unique<ModelState>(path.string());
+            ms->session->scene(ms->scene);
+            return ms;
+        };
+
+        std::future<std::unique_ptr<ModelState>> next_model;
+        if (not opts.models.empty()) {
+            next_model = std::async(std::launch::async, extract, opts.models.front());
+        }
+
+        float const line_width = 0.002f;
+        float const fov = glm::radians(45.0f);
+        float const aspect_ratio = static_cast<float>(opts.w) / static_cast<float>(opts.h);
+        Visibility visible;
+        Lod_levels lod_levels;
+
+        for (size_t model = 0; model < opts.models.size(); ++model) {
+            std::filesystem::path const& path = opts.models[model];
+
+            std::unique_ptr<ModelState> ms;
+            auto wait_start = clock::now();
+            try {
+                ms = next_model.get();
+            } catch (std::exception const& ex) {
+                std::cerr << path.string() << ": failed: " << ex.what() << std::endl;
+                ++stats.failures;
+            }
+            stats.extract_wait_s += seconds_since(wait_start);
+
+            if (model + 1 < opts.models.size()) {
+                next_model = std::async(std::launch::async, extract, opts.models[model + 1]);
+            }
+            if (not ms) {
+                continue;
+            }
+            ++stats.models;
+
+            auto render_start = clock::now();
+            upload_meshes(gls, mesh_cache, *ms);
+            ms->bvh.build(ms->scene, ms->mesh_bounds, line_width);
+            visible.reset(ms->scene, 1);
+
+            // frame the scene's bounding sphere, whichever FoV is narrower
+            glm::vec3 pan = {0.0f, 0.0f, 0.0f};
+            float scene_radius = 1.0f;
+            if (std::optional<AABB> bounds = ms->bvh.bounds(); bounds) {
+                pan = -aabb_center(*bounds);
+                scene_radius = std::max(glm::length(bounds->max - bounds->min) / 2.0f, 1e-3f);
+            }
+            float fov_x = 2.0f * std::atan(std::tan(fov / 2.0f) * aspect_ratio);
+            float radius = scene_radius / std::sin(std::min(fov, fov_x) / 2.0f);
+            auto proj_matrix = glm::perspective(fov, aspect_ratio, std::max(radius - scene_radius, radius * 1e-3f), radius + scene_radius);
+
+            for (Camera_preset const& view : opts.views) {
+                auto view_matrix = orbit_view_matrix(view.theta, view.phi, radius, pan);
+                glm::vec3 camera_pos = glm::vec3{glm::inverse(view_matrix)[3]};
 
-            // software-throttle the framerate: no need to render at an insane
-            // (e.g. 2000 FPS, on my machine) FPS, but do not use VSYNC because
-            // it makes the entire application feel *very* laggy.
-            auto now = std::chrono::high_resolution_clock::now();
-            auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_render_timepoint);
-            if (dt < min_delay_between_frames) {
-                SDL_Delay(static_cast<Uint32>((min_delay_between_frames - dt).count()));
+                Lod_selector lod_selector{view_matrix, proj_matrix, opts.h, 1.0f, true};
+                select_lods(ms->scene, visible, gls, ms->gpu_meshes, lod_selector, lod_levels);
+
+                target.bind();
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                gl::UseProgram(gls.program);
+                glglm::Uniform(gls.projMat, proj_matrix);
+                glglm::Uniform(gls.viewMat, view_matrix);
+                glglm::Uniform(gls.light_pos, camera_pos);  // headlight
+                glglm::Uniform(gls.light_color, glm::vec3{0.98f, 0.95f, 0.95f});
+                glglm::Uniform(gls.view_pos, camera_pos);
+
+                render_queue.begin(view_matrix, radius + scene_radius);
+                push_scene(render_queue, gls, *ms, visible, lod_levels, line_width, true);
+                render_queue.flush(gls);
+                gl::UseProgram();
+
+                std::filesystem::path out = opts.out_dir / path.stem();
+                out += "_"s + view.name + (opts.format == Image_format::png ? ".png" : ".ppm");
+                if (std::optional<Frame> done = readback.read(target.resolve(), std::move(out)); done) {
+                    write_async(std::move(*done));
+                }
+            }
+            gl::BindFramebuffer();
+            stats.render_s += seconds_since(render_start);
+        }
+
+        for (Frame& f : readback.drain()) {
+            write_async(std::move(f));
+        }
+        if (writing.valid()) {
+            auto t = clock::now();
+            try {
+                writing.get();
+            } catch (std::exception const& ex) {
+                std::cerr << "render: " << ex.what() << std::endl;
+                ++stats.failures;
+            }
+            stats.write_wait_s += seconds_since(t);
+        }
+
+        stats.total_s = seconds_since(start);
+        return stats;
+    }
+}
+
+static const char* render_usage = R"(usage: osim-snippets render [options] <dir|model.osim>...
+
+Renders .osim models (every .osim found, recursively, in directories) to
+images without opening a window. Uses SDL's EGL-backed "offscreen" video
+driver, which works on machines with no display or GPU (e.g. with Mesa's
+llvmpipe), unless SDL_VIDEODRIVER is set.
+
+Images are written as <out>/<model>_<view>.<format>.
+
+options:
+    --out <dir>         output directory (default: .)
+    --size <w>x<h>      image size (default: 256x256)
+    --views <v1,v2...>  camera presets: front, back, left, right, top,
+                        bottom, or all (default: front)
+    --format png|ppm    image format (default: png)
+    --samples <n>       MSAA samples, 1 to disable (default: 4)
+)";
+
+int oss_render(int argc, char** argv) {
+    using namespace examples::imgui;
+
+    Render_options opts;
+    std::vector<std::string> view_names = {"front"};
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error{std::string{arg} + ": missing value"};
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--out") {
+                opts.out_dir = value();
+            } else if (arg == "--size") {
+                std::string v = value();
+                if (std::sscanf(v.c_str(), "%dx%d", &opts.w, &opts.h) != 2 or opts.w <= 0 or opts.h <= 0) {
+                    throw std::runtime_error{"--size: expected <w>x<h>, got: " + v};
+                }
+            } else if (arg == "--views") {
+                std::stringstream ss{value()};
+                view_names.clear();
+                for (std::string name; std::getline(ss, name, ',');) {
+                    view_names.push_back(name);
+                }
+            } else if (arg == "--format") {
+                std::string v = value();
+                if (v == "png") {
+                    opts.format = Image_format::png;
+                } else if (v == "ppm") {
+                    opts.format = Image_format::ppm;
+                } else {
+                    throw std::runtime_error{"--format: expected png or ppm, got: " + v};
+                }
+            } else if (arg == "--samples") {
+                opts.samples = std::max(1, std::atoi(value().c_str()));
+            } else if (std::filesystem::is_directory(arg)) {
+                for (auto const& entry : std::filesystem::recursive_directory_iterator{arg}) {
+                    if (entry.is_regular_file() and entry.path().extension() == ".osim") {
+                        opts.models.push_back(entry.path());
+                    }
+                }
+            } else {
+                opts.models.emplace_back(arg);
             }
+        }
 
-            // draw
-            SDL_GL_SwapWindow(s.window);
-            last_render_timepoint = std::chrono::high_resolution_clock::now();
+        for (std::string const& name : view_names) {
+            if (name == "all") {
+                opts.views.assign(std::begin(camera_presets), std::end(camera_presets));
+                continue;
+            }
+            auto it = std::find_if(std::begin(camera_presets), std::end(camera_presets), [&](Camera_preset const& p) {
+                return name == p.name;
+            });
+            if (it == std::end(camera_presets)) {
+                throw std::runtime_error{"--views: unknown view: " + name};
+            }
+            opts.views.push_back(*it);
         }
+    } catch (std::exception const& ex) {
+        std::cerr << "render: " << ex.what() << std::endl << render_usage << std::endl;
+        return -1;
+    }
+
+    if (opts.models.empty()) {
+        std::cerr << render_usage << std::endl;
+        return -1;
     }
+
+    Render_stats stats;
+    try {
+        std::filesystem::create_directories(opts.out_dir);
+        auto headless = ui::Headless_state{};
+        stats = render(headless, opts);
+    } catch (std::exception const& ex) {
+        std::cerr << "render: failed: " << ex.what() << std::endl;
+        return -1;
+    }
+
+    auto per_s = [&](size_t n, double s) {
+        return s > 0.0 ? static_cast<double>(n) / s : 0.0;
+    };
+    std::cout << "models:        " << stats.models << " (" << stats.failures << " failures)" << std::endl
+              << "frames:        " << stats.frames << " (" << opts.w << "x" << opts.h << ", " << opts.samples << "x MSAA)" << std::endl
+              << "took:          " << stats.total_s << " s" << std::endl
+              << "throughput:    " << per_s(stats.frames, stats.total_s) << " frames/s, "
+                                   << per_s(stats.models, stats.total_s) << " models/s" << std::endl
+              << "render:        " << stats.render_s << " s (" << per_s(stats.frames, stats.render_s) << " frames/s on the GL thread)" << std::endl
+              << "extract wait:  " << stats.extract_wait_s << " s" << std::endl
+              << "write wait:    " << stats.write_wait_s << " s" << std::endl;
+
+    return stats.failures == 0 ? 0 : -1;
 }
 
-int oss_show(int, char** argv) {
+int oss_show(int argc, char** argv) {
     auto ui = ui::State{};
 
-    // TODO: better handling
-    examples::imgui::show(ui, argv[2]);
+    // TODO: better handling. Every model given can be switched to in the UI
+    std::vector<std::string> files(argv + 2, argv + std::max(argc, 2));
+    examples::imgui::show(ui, files);
 
     return 0;
 };
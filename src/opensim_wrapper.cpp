@@ -1,21 +1,48 @@
 #include "opensim_wrapper.hpp"
+#include "mesh_cache.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <OpenSim/OpenSim.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// x86-64 always has SSE2 (MSVC doesn't define __SSE2__, so check _M_X64)
+#if defined(__SSE2__) || defined(_M_X64)
+#define OSIM_COMPOSE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 using namespace SimTK;
 using namespace OpenSim;
 
 namespace {
-    void generateGeometry(Model& model, State const& state, Array_<DecorativeGeometry>& geometry) {
-        model.generateDecorations(true, model.getDisplayHints(), state, geometry);
+    // Appends either the fixed decorations (`fixed == true`: geometry that is
+    // rigidly attached to a body, such as bone meshes) or the variable ones
+    // (`fixed == false`: geometry that depends on the state, such as muscle
+    // paths) of `model` to `geometry`.
+    void generateGeometry(Model& model, State const& state, bool fixed, Array_<DecorativeGeometry>& geometry) {
+        model.generateDecorations(fixed, model.getDisplayHints(), state, geometry);
         ComponentList<const Component> allComps = model.getComponentList();
         ComponentList<Component>::const_iterator iter = allComps.begin();
         while (iter != allComps.end()){
             //std::string cn = iter->getConcreteClassName();
             //std::cout << cn << ":" << iter->getName() << std::endl;
-            iter->generateDecorations(true, model.getDisplayHints(), state, geometry);
+            iter->generateDecorations(fixed, model.getDisplayHints(), state, geometry);
             iter++;
         }
 
@@ -24,86 +51,621 @@ namespace {
         //dg.generateDecorations(state, geometry);
     }
 
+    glm::vec3 to_vec3(Vec3 const& v) {
+        return glm::vec3{v[0], v[1], v[2]};
+    }
+
+    glm::mat4 to_mat4(Transform const& t) {
+        glm::mat4 m = glm::identity<glm::mat4>();
+
+        // glm::mat4 is column major:
+        //     see: https://glm.g-truc.net/0.9.2/api/a00001.html
+        //     (and just Google "glm column major?")
+        //
+        // SimTK is whoknowswtf-major (actually, row), carefully read the
+        // sourcecode for `SimTK::Transform`.
+
+        // x
+        m[0][0] = t.R().row(0)[0];
+        m[0][1] = t.R().row(1)[0];
+        m[0][2] = t.R().row(2)[0];
+        m[0][3] = 0.0f;
+
+        // y
+        m[1][0] = t.R().row(0)[1];
+        m[1][1] = t.R().row(1)[1];
+        m[1][2] = t.R().row(2)[1];
+        m[1][3] = 0.0f;
+
+        // z
+        m[2][0] = t.R().row(0)[2];
+        m[2][1] = t.R().row(1)[2];
+        m[2][2] = t.R().row(2)[2];
+        m[2][3] = 0.0f;
+
+        // w
+        m[3][0] = t.p()[0];
+        m[3][1] = t.p()[1];
+        m[3][2] = t.p()[2];
+        m[3][3] = 1.0f;
+
+        return m;
+    }
+
+    // Fills `out` with the ground-to-body transform of every body in the
+    // model, indexed by `MobilizedBodyIndex`. Each body's transform is fetched
+    // and converted to single precision exactly once per state.
+    void body_transforms(Model const& model, State const& state, std::vector<glm::mat4>& out) {
+        SimbodyMatterSubsystem const& ms = model.getSystem().getMatterSubsystem();
+        int n = ms.getNumBodies();
+        out.resize(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            out[static_cast<size_t>(i)] = to_mat4(ms.getMobilizedBody(MobilizedBodyIndex(i)).getBodyTransform(state));
+        }
+    }
+
+    // out[i] = bodies[body_indices[i]] * locals[i]
+    //
+    // Plain glm loop: the fallback for `compose_transforms`, and its
+    // baseline in `benchmark_transforms`
+    void compose_transforms_scalar(std::span<glm::mat4 const> bodies,
+                                   std::span<int const> body_indices,
+                                   std::span<glm::mat4 const> locals,
+                                   glm::mat4* out) {
+        for (size_t i = 0; i < locals.size(); ++i) {
+            out[i] = bodies[static_cast<size_t>(body_indices[i])] * locals[i];
+        }
+    }
+
+    // out[i] = bodies[body_indices[i]] * locals[i]
+    //
+    // With SSE2, each output column is computed 4 rows at a time: it's the
+    // body's columns, weighted by the local matrix's column, so it's 4
+    // broadcasts, 4 multiplies and 3 adds. glm only uses intrinsics for its
+    // aligned types (and only with GLM_FORCE_INTRINSICS), so this is done by
+    // hand over the (unaligned) column-major floats. The operations are the
+    // same, in the same order, as glm's scalar product.
+    void compose_transforms(std::span<glm::mat4 const> bodies,
+                            std::span<int const> body_indices,
+                            std::span<glm::mat4 const> locals,
+                            glm::mat4* out) {
+#ifdef OSIM_COMPOSE_SSE2
+        for (size_t i = 0; i < locals.size(); ++i) {
+            float const* a = &bodies[static_cast<size_t>(body_indices[i])][0][0];
+            float const* b = &locals[i][0][0];
+            float* c = &out[i][0][0];
 
-    // A hacky decoration generator that just always generates all geometry,
-    // even if it's static.
-    struct DynamicDecorationGenerator : public DecorationGenerator {
-        Model* _model;
-        DynamicDecorationGenerator(Model* model) : _model{model} {
-            assert(_model != nullptr);
+            __m128 a0 = _mm_loadu_ps(a);
+            __m128 a1 = _mm_loadu_ps(a + 4);
+            __m128 a2 = _mm_loadu_ps(a + 8);
+            __m128 a3 = _mm_loadu_ps(a + 12);
+            for (int col = 0; col < 4; ++col) {
+                float const* bc = b + 4*col;
+                __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+                r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+                _mm_storeu_ps(c + 4*col, r);
+            }
         }
-        void useModel(Model* newModel) {
-            assert(newModel != nullptr);
-            _model = newModel;
+#else
+        compose_transforms_scalar(bodies, body_indices, locals, out);
+#endif
+    }
+
+    // out[i] = bodies[body_indices[i]] * points[i] (as in `compose_transforms`)
+    void compose_points(std::span<glm::mat4 const> bodies,
+                        std::span<int const> body_indices,
+                        std::span<glm::vec3 const> points,
+                        glm::vec3* out) {
+#ifdef OSIM_COMPOSE_SSE2
+        for (size_t i = 0; i < points.size(); ++i) {
+            float const* a = &bodies[static_cast<size_t>(body_indices[i])][0][0];
+            glm::vec3 const& p = points[i];
+
+            // summed pairwise, as glm's mat4 * vec4 does
+            __m128 xy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(p.x)),
+                                   _mm_mul_ps(_mm_loadu_ps(a + 4), _mm_set1_ps(p.y)));
+            __m128 zw = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + 8), _mm_set1_ps(p.z)),
+                                   _mm_loadu_ps(a + 12));
+            __m128 r = _mm_add_ps(xy, zw);
+
+            // vec3s are packed, so a 4-wide store would overrun the array
+            alignas(16) float xyzw[4];
+            _mm_store_ps(xyzw, r);
+            out[i] = glm::vec3{xyzw[0], xyzw[1], xyzw[2]};
+        }
+#else
+        for (size_t i = 0; i < points.size(); ++i) {
+            out[i] = glm::vec3{bodies[static_cast<size_t>(body_indices[i])] * glm::vec4{points[i], 1.0f}};
+        }
+#endif
+    }
+
+    // Returns the number of vertices `triangulate` will emit for `mesh`: one
+    // per mesh vertex, plus a center vertex per polygon with > 4 edges
+    size_t num_triangulated_vertices(PolygonalMesh const& mesh) {
+        size_t n = static_cast<size_t>(mesh.getNumVertices());
+        for (int face = 0; face < mesh.getNumFaces(); ++face) {
+            if (mesh.getNumVerticesForFace(face) > 4) {
+                ++n;
+            }
         }
+        return n;
+    }
 
-        void generateDecorations(const State& state, Array_<DecorativeGeometry>& geometry) override {
-            generateGeometry(*_model, state, geometry);
+    // Triangulates `mesh`'s faces into an index buffer. The mesh's vertex
+    // list is copied into `vertices` as-is, so that faces can share vertices.
+    template<typename Index>
+    std::vector<Index> triangulate(PolygonalMesh const& mesh, std::vector<glm::vec3>& vertices) {
+        vertices.clear();
+        vertices.reserve(num_triangulated_vertices(mesh));
+        for (int vert = 0; vert < mesh.getNumVertices(); ++vert) {
+            vertices.push_back(to_vec3(mesh.getVertexPosition(vert)));
         }
+
+        std::vector<Index> indices;
+        indices.reserve(3 * static_cast<size_t>(mesh.getNumFaces()));
+
+        // helper function: gets a vertex index for a face
+        auto get_face_vert = [&](int face, int vert) {
+            return static_cast<Index>(mesh.getFaceVertex(face, vert));
+        };
+
+        auto push_triangle = [&](Index a, Index b, Index c) {
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(c);
+        };
+
+        for (auto face = 0; face < mesh.getNumFaces(); ++face) {
+            auto num_vertices = mesh.getNumVerticesForFace(face);
+
+            if (num_vertices < 3) {
+                // do nothing
+            } else if (num_vertices == 3) {
+                // standard triangle face
+
+                push_triangle(get_face_vert(face, 0), get_face_vert(face, 1), get_face_vert(face, 2));
+            } else if (num_vertices == 4) {
+                // rectangle: split into two triangles
+
+                push_triangle(get_face_vert(face, 0), get_face_vert(face, 1), get_face_vert(face, 2));
+                push_triangle(get_face_vert(face, 2), get_face_vert(face, 3), get_face_vert(face, 0));
+            } else {
+                // polygon with >= 4 edges:
+                //
+                // create a vertex at the average center point and attach
+                // every two verices to the center as triangles.
+
+                auto center = glm::vec3{0.0f, 0.0f, 0.0f};
+                for (int vert = 0; vert < num_vertices; ++vert) {
+                    center += vertices[get_face_vert(face, vert)];
+                }
+                center /= num_vertices;
+
+                auto center_idx = static_cast<Index>(vertices.size());
+                vertices.push_back(center);
+
+                for (int vert = 0; vert < num_vertices-1; ++vert) {
+                    push_triangle(get_face_vert(face, vert), get_face_vert(face, vert+1), center_idx);
+                }
+                // loop back
+                push_triangle(get_face_vert(face, num_vertices-1), get_face_vert(face, 0), center_idx);
+            }
+        }
+
+        return indices;
+    }
+
+    // Returns smooth per-vertex normals for an indexed mesh: each vertex's
+    // normal is the (area-weighted) average of the normals of the faces that
+    // share it
+    template<typename Index>
+    std::vector<glm::vec3> vertex_normals(std::vector<glm::vec3> const& verts,
+                                          std::vector<Index> const& indices) {
+        std::vector<glm::vec3> rv(verts.size(), glm::vec3{0.0f, 0.0f, 0.0f});
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            glm::vec3 const& p1 = verts[indices[i]];
+            glm::vec3 const& p2 = verts[indices[i+1]];
+            glm::vec3 const& p3 = verts[indices[i+2]];
+            // unnormalized: its length is proportional to the face's area
+            glm::vec3 normal = glm::cross(p2 - p1, p3 - p1);
+            rv[indices[i]] += normal;
+            rv[indices[i+1]] += normal;
+            rv[indices[i+2]] += normal;
+        }
+        for (glm::vec3& n : rv) {
+            float len = glm::length(n);
+            n = len > 0.0f ? n/len : glm::vec3{0.0f, 1.0f, 0.0f};
+        }
+        return rv;
+    }
+
+    // Heap storage behind a freshly-triangulated osim::Mesh_data
+    template<typename Index>
+    struct Mesh_buffers final {
+        std::vector<osim::Mesh_vertex> vertices;
+        std::vector<Index> indices;
     };
 
-    struct Geometry_visitor final : public DecorativeGeometryImplementation {
-        Model& model;
-        State& state;
-        std::vector<osim::Geometry>& out;
+    template<typename Index>
+    osim::Mesh_data triangulate_with_normals(PolygonalMesh const& mesh) {
+        std::vector<glm::vec3> positions;
+        auto buffers = std::make_shared<Mesh_buffers<Index>>();
+        buffers->indices = triangulate<Index>(mesh, positions);
 
-        Geometry_visitor(Model& _model,
-                         State& _state,
-                         std::vector<osim::Geometry>& _out) :
-            model{_model},
-            state{_state},
-            out{_out} {
+        std::vector<glm::vec3> normals = vertex_normals(positions, buffers->indices);
+        buffers->vertices.reserve(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            buffers->vertices.push_back(osim::Mesh_vertex{positions[i], normals[i]});
         }
 
-        Transform ground_to_decoration_xform(DecorativeGeometry const& geom) {
-            SimbodyMatterSubsystem const& ms = model.getSystem().getMatterSubsystem();
-            MobilizedBody const& mobod = ms.getMobilizedBody(MobilizedBodyIndex(geom.getBodyId()));
-            Transform const& ground_to_body_xform = mobod.getBodyTransform(state);
-            Transform const& body_to_decoration_xform = geom.getTransform();
+        osim::Mesh_data rv;
+        rv.vertices = buffers->vertices;
+        rv.indices = std::span<Index const>{buffers->indices};
+        rv.storage = std::move(buffers);
+        return rv;
+    }
 
-            return ground_to_body_xform * body_to_decoration_xform;
+    osim::Mesh_data triangulate(PolygonalMesh const& mesh) {
+        if (num_triangulated_vertices(mesh) <= std::numeric_limits<std::uint16_t>::max()) {
+            return triangulate_with_normals<std::uint16_t>(mesh);
+        } else {
+            return triangulate_with_normals<std::uint32_t>(mesh);
         }
+    }
 
-        glm::mat4 transform(DecorativeGeometry const& geom) {
-            Transform t = ground_to_decoration_xform(geom);
-            glm::mat4 m = glm::identity<glm::mat4>();
+    struct Cached_mesh final {
+        osim::Mesh_id id;
+        std::shared_ptr<osim::Mesh_data const> data;
+    };
 
-            // glm::mat4 is column major:
-            //     see: https://glm.g-truc.net/0.9.2/api/a00001.html
-            //     (and just Google "glm column major?")
-            //
-            // SimTK is whoknowswtf-major (actually, row), carefully read the
-            // sourcecode for `SimTK::Transform`.
+    // Process-wide cache of triangulated meshes
+    //
+    // Entries are content-addressed (keyed by a hash of the mesh file), so
+    // that identical meshes are only triangulated once, even if they're
+    // loaded via different paths or by different models. The path -> hash
+    // lookup is also cached (invalidated by mtime/size) so that a file is
+    // only re-hashed if it changed.
+    //
+    // Misses fall back to the on-disk cache (mesh_cache.hpp), which avoids
+    // parsing + triangulating the mesh file at all, and only then to
+    // triangulating it (which also writes a disk cache entry).
+    class Mesh_cache final {
+        struct File_hash final {
+            std::int64_t mtime;
+            std::uint64_t size;
+            std::uint64_t hash;
+        };
 
-            // x
-            m[0][0] = t.R().row(0)[0];
-            m[0][1] = t.R().row(1)[0];
-            m[0][2] = t.R().row(2)[0];
-            m[0][3] = 0.0f;
+        std::mutex mutex;
+        std::unordered_map<std::string, File_hash> file_hashes;
+        std::unordered_map<std::uint64_t, Cached_mesh> entries;
+        std::unordered_map<std::string, std::shared_future<Cached_mesh>> in_flight;
+        osim::Mesh_id next_id = 0;
+        std::size_t hits = 0;
+        std::size_t disk_hits = 0;
+        std::size_t misses = 0;
 
-            // y
-            m[1][0] = t.R().row(0)[1];
-            m[1][1] = t.R().row(1)[1];
-            m[1][2] = t.R().row(2)[1];
-            m[1][3] = 0.0f;
+        // must be called with `mutex` held
+        std::optional<std::uint64_t> memoized_hash(osim::Mesh_source const& src) {
+            if (auto it = file_hashes.find(src.path.string()); it != file_hashes.end()) {
+                if (it->second.mtime == src.mtime and it->second.size == src.size) {
+                    return it->second.hash;
+                }
+            }
+            return std::nullopt;
+        }
 
-            // z
-            m[2][0] = t.R().row(0)[2];
-            m[2][1] = t.R().row(1)[2];
-            m[2][2] = t.R().row(2)[2];
-            m[2][3] = 0.0f;
+        // must be called with `mutex` held
+        Cached_mesh insert(osim::Mesh_source const& src, std::uint64_t hash, osim::Mesh_data data) {
+            file_hashes[src.path.string()] = File_hash{src.mtime, src.size, hash};
+
+            // another thread may have loaded the same mesh in the meantime
+            auto [it, inserted] = entries.try_emplace(
+                hash,
+                Cached_mesh{next_id, std::make_shared<osim::Mesh_data const>(std::move(data))});
+            if (inserted) {
+                ++next_id;
+            }
+            return it->second;
+        }
 
-            // w
-            m[3][0] = t.p()[0];
-            m[3][1] = t.p()[1];
-            m[3][2] = t.p()[2];
-            m[3][3] = 1.0f;
+        // loads a mesh that isn't in memory: must be called without `mutex`
+        // held, because it does I/O and (maybe) triangulation
+        Cached_mesh load_uncached(DecorativeMeshFile const& m, osim::Mesh_source const& src) {
+            // disk cache: no parsing/triangulation, just a file mapping
+            if (std::optional<osim::Disk_cached_mesh> cached = osim::disk_cache_load(src); cached) {
+                std::lock_guard lock{mutex};
+                ++disk_hits;
+                return insert(src, cached->content_hash, std::move(cached->data));
+            }
 
-            return m;
+            // the file's contents may already be cached under another path
+            std::optional<std::uint64_t> hash = osim::hash_file(src.path);
+            if (hash) {
+                std::unique_lock lock{mutex};
+                if (auto it = entries.find(*hash); it != entries.end()) {
+                    ++hits;
+                    file_hashes[src.path.string()] = File_hash{src.mtime, src.size, *hash};
+                    Cached_mesh rv = it->second;
+                    lock.unlock();
+                    osim::disk_cache_store(src, *hash, *rv.data);
+                    return rv;
+                }
+            }
+
+            // miss: parse + triangulate
+            osim::Mesh_data data = triangulate(m.getMesh());
+            if (hash) {
+                osim::disk_cache_store(src, *hash, data);
+            }
+
+            std::lock_guard lock{mutex};
+            ++misses;
+            if (not hash) {
+                return Cached_mesh{next_id++, std::make_shared<osim::Mesh_data const>(std::move(data))};
+            }
+            return insert(src, *hash, std::move(data));
+        }
+
+    public:
+        // Thread-safe. If several threads load the same (uncached) file at
+        // the same time, only one of them loads it and the others wait for it.
+        Cached_mesh load(DecorativeMeshFile const& m) {
+            std::optional<osim::Mesh_source> src = osim::mesh_source(m.getMeshFile());
+            if (not src) {
+                // can't address the mesh by content (e.g. it isn't on disk):
+                // triangulate it but don't cache it
+                auto data = std::make_shared<osim::Mesh_data const>(triangulate(m.getMesh()));
+                std::lock_guard lock{mutex};
+                ++misses;
+                return Cached_mesh{next_id++, std::move(data)};
+            }
+
+            std::string key = src->path.string();
+            std::promise<Cached_mesh> promise;
+            {
+                std::unique_lock lock{mutex};
+
+                // fast path: file seen before, and unchanged
+                if (std::optional<std::uint64_t> hash = memoized_hash(*src); hash) {
+                    if (auto it = entries.find(*hash); it != entries.end()) {
+                        ++hits;
+                        return it->second;
+                    }
+                }
+
+                // another thread is already loading this file
+                if (auto it = in_flight.find(key); it != in_flight.end()) {
+                    ++hits;
+                    std::shared_future<Cached_mesh> loading = it->second;
+                    lock.unlock();
+                    return loading.get();
+                }
+
+                in_flight.emplace(key, promise.get_future().share());
+            }
+
+            try {
+                Cached_mesh rv = load_uncached(m, *src);
+                promise.set_value(rv);
+                std::lock_guard lock{mutex};
+                in_flight.erase(key);
+                return rv;
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+                std::lock_guard lock{mutex};
+                in_flight.erase(key);
+                throw;
+            }
+        }
+
+        osim::Mesh_cache_stats stats() {
+            std::lock_guard lock{mutex};
+            return {
+                .hits = hits,
+                .disk_hits = disk_hits,
+                .misses = misses,
+                .entries = entries.size(),
+            };
+        }
+    };
+
+    Mesh_cache& global_mesh_cache() {
+        static Mesh_cache cache;
+        return cache;
+    }
+
+    // Fixed-size pool of worker threads that runs submitted tasks in FIFO
+    // order
+    class Worker_pool final {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+
+        void run() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [&]() { return stopping or not tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;  // stopping, and all work is done
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        Worker_pool(unsigned num_threads) {
+            for (unsigned i = 0; i < num_threads; ++i) {
+                workers.emplace_back([this]() { run(); });
+            }
+        }
+        Worker_pool(Worker_pool const&) = delete;
+        Worker_pool(Worker_pool&&) = delete;
+        Worker_pool& operator=(Worker_pool const&) = delete;
+        Worker_pool& operator=(Worker_pool&&) = delete;
+        ~Worker_pool() noexcept {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            for (std::thread& t : workers) {
+                t.join();
+            }
         }
 
-        glm::vec3 to_vec3(Vec3 const& v) {
-            return glm::vec3{v[0], v[1], v[2]};
+        // the returned future rethrows anything `f` throws
+        template<typename F>
+        auto submit(F f) -> std::future<std::invoke_result_t<F>> {
+            using Result = std::invoke_result_t<F>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(f));
+            std::future<Result> rv = task->get_future();
+            {
+                std::lock_guard lock{mutex};
+                tasks.emplace_back([task]() { (*task)(); });
+            }
+            cv.notify_one();
+            return rv;
+        }
+    };
+
+    // Pool that mesh loading (parsing, triangulation, normals) runs on
+    Worker_pool& mesh_workers() {
+        static Worker_pool pool{std::max(1u, std::thread::hardware_concurrency())};
+        return pool;
+    }
+
+    // Which body each element of a (body-local) scene is attached to
+    struct Body_indices final {
+        std::vector<int> cylinders;
+        std::vector<int> spheres;
+        std::vector<int> lines;
+        std::vector<int> meshes;
+    };
+
+    // Sink that appends everything it receives to a `Scene`
+    class Scene_sink final : public osim::Geometry_sink {
+        osim::Scene& out;
+        std::unordered_map<osim::Mesh_id, std::uint32_t> pool_lut;
+
+    public:
+        Scene_sink(osim::Scene& _out) : out{_out} {
+            for (osim::Mesh_id id : out.mesh_pool.ids) {
+                pool_lut.emplace(id, static_cast<std::uint32_t>(pool_lut.size()));
+            }
+        }
+
+        void cylinder(osim::Cylinder const& c) override {
+            out.cylinders.transforms.push_back(c.transform);
+            out.cylinders.scales.push_back(c.scale);
+            out.cylinders.colors.push_back(c.rgba);
+        }
+        void sphere(osim::Sphere const& s) override {
+            out.spheres.transforms.push_back(s.transform);
+            out.spheres.colors.push_back(s.rgba);
+            out.spheres.radii.push_back(s.radius);
+        }
+        void line(osim::Line const& l) override {
+            out.lines.p1s.push_back(l.p1);
+            out.lines.p2s.push_back(l.p2);
+            out.lines.colors.push_back(l.rgba);
+        }
+        void mesh(osim::Mesh const& m) override {
+            auto [it, inserted] = pool_lut.try_emplace(m.mesh_id, static_cast<std::uint32_t>(out.mesh_pool.size()));
+            if (inserted) {
+                out.mesh_pool.ids.push_back(m.mesh_id);
+                out.mesh_pool.data.push_back(m.data);
+            }
+            out.meshes.transforms.push_back(m.transform);
+            out.meshes.scales.push_back(m.scale);
+            out.meshes.colors.push_back(m.rgba);
+            out.meshes.pool_indices.push_back(it->second);
+        }
+    };
+
+    // Sink that appends everything it receives to a vector of variants
+    class Vector_sink final : public osim::Geometry_sink {
+        std::vector<osim::Geometry>& out;
+
+    public:
+        Vector_sink(std::vector<osim::Geometry>& _out) : out{_out} {
+        }
+
+        void cylinder(osim::Cylinder const& c) override {
+            out.push_back(c);
+        }
+        void sphere(osim::Sphere const& s) override {
+            out.push_back(s);
+        }
+        void line(osim::Line const& l) override {
+            out.push_back(l);
+        }
+        void mesh(osim::Mesh const& m) override {
+            out.push_back(m);
+        }
+    };
+
+    struct Pending_mesh final {
+        glm::mat4 transform;
+        glm::vec3 scale;
+        glm::vec4 rgba;
+        std::future<Cached_mesh> loading;
+    };
+
+    struct Geometry_visitor final : public DecorativeGeometryImplementation {
+        Model& model;
+        State& state;
+        osim::Geometry_sink& out;
+
+        // if non-null, geometry is emitted in body-local coordinates (rather
+        // than ground) and each element's body is recorded here
+        Body_indices* bodies;
+
+        // meshes are loaded in parallel on `mesh_workers()`, and are only
+        // emitted (in visitation order) by `finish()`
+        std::vector<Pending_mesh> pending_meshes;
+
+        // ground-to-body transforms, indexed by body, for `state`. Only used
+        // when emitting geometry in ground coordinates
+        std::span<glm::mat4 const> body_xforms;
+
+        Geometry_visitor(Model& _model,
+                         State& _state,
+                         osim::Geometry_sink& _out,
+                         std::span<glm::mat4 const> _body_xforms) :
+            model{_model},
+            state{_state},
+            out{_out},
+            bodies{nullptr},
+            body_xforms{_body_xforms} {
+        }
+
+        Geometry_visitor(Model& _model,
+                         State& _state,
+                         osim::Geometry_sink& _out,
+                         Body_indices& _bodies) :
+            model{_model},
+            state{_state},
+            out{_out},
+            bodies{&_bodies} {
+        }
+
+        glm::mat4 transform(DecorativeGeometry const& geom) {
+            glm::mat4 body_to_decoration = to_mat4(geom.getTransform());
+            if (bodies) {
+                return body_to_decoration;
+            }
+            return body_xforms[static_cast<size_t>(geom.getBodyId())] * body_to_decoration;
         }
 
         glm::vec3 scale_factors(DecorativeGeometry const& geom) {
@@ -130,11 +692,14 @@ namespace {
             glm::mat4 xform = transform(geom);
             glm::vec4 p1 = xform * to_vec4(geom.getPoint1());
             glm::vec4 p2 = xform * to_vec4(geom.getPoint2());
-            out.push_back(osim::Line{
+            out.line(osim::Line{
                 .p1 = {p1.x, p1.y, p1.z},
                 .p2 = {p2.x, p2.y, p2.z},
-                .rgba = rgba(geom)
+                .rgba = rgba(geom),
             });
+            if (bodies) {
+                bodies->lines.push_back(geom.getBodyId());
+            }
         }
         void implementBrickGeometry(const DecorativeBrick&) override {
         }
@@ -145,20 +710,26 @@ namespace {
             s.y *= geom.getHalfHeight();
             s.z *= geom.getRadius();
 
-            out.push_back(osim::Cylinder{
+            out.cylinder(osim::Cylinder{
                 .transform = m,
                 .scale = s,
                 .rgba = rgba(geom),
             });
+            if (bodies) {
+                bodies->cylinders.push_back(geom.getBodyId());
+            }
         }
         void implementCircleGeometry(const DecorativeCircle&) override {
         }
         void implementSphereGeometry(const DecorativeSphere& geom) override {
-            out.push_back(osim::Sphere{
+            out.sphere(osim::Sphere{
                 .transform = transform(geom),
                 .rgba = rgba(geom),
                 .radius = static_cast<float>(geom.getRadius()),
             });
+            if (bodies) {
+                bodies->spheres.push_back(geom.getBodyId());
+            }
         }
         void implementEllipsoidGeometry(const DecorativeEllipsoid&) override {
         }
@@ -169,75 +740,18 @@ namespace {
         void implementMeshGeometry(const DecorativeMesh&) override {
         }
         void implementMeshFileGeometry(const DecorativeMeshFile& m) override {
-            PolygonalMesh const& mesh = m.getMesh();
-
-            // helper function: gets a vertex for a face
-            auto get_face_vert = [&](int face, int vert) {
-                return to_vec3(mesh.getVertexPosition(mesh.getFaceVertex(face, vert)));
-            };
-
-            std::vector<osim::Triangle> triangles;
-
-            for (auto face = 0; face < mesh.getNumFaces(); ++face) {
-                auto num_vertices = mesh.getNumVerticesForFace(face);
-
-                if (num_vertices < 3) {
-                    // do nothing
-                } else if (num_vertices == 3) {
-                    // standard triangle face
-
-                    triangles.push_back(osim::Triangle{
-                        get_face_vert(face, 0),
-                        get_face_vert(face, 1),
-                        get_face_vert(face, 2)
-                    });
-                } else if (num_vertices == 4) {
-                    // rectangle: split into two triangles
-
-                    triangles.push_back(osim::Triangle{
-                        get_face_vert(face, 0),
-                        get_face_vert(face, 1),
-                        get_face_vert(face, 2)
-                    });
-                    triangles.push_back(osim::Triangle{
-                        get_face_vert(face, 2),
-                        get_face_vert(face, 3),
-                        get_face_vert(face, 0)
-                    });
-                } else {
-                    // polygon with >= 4 edges:
-                    //
-                    // create a vertex at the average center point and attach
-                    // every two verices to the center as triangles.
-
-                    auto center = glm::vec3{0.0f, 0.0f, 0.0f};
-                    for (int vert = 0; vert < num_vertices; ++vert) {
-                        center += get_face_vert(face, vert);
-                    }
-                    center /= num_vertices;
-
-                    for (int vert = 0; vert < num_vertices-1; ++vert) {
-                        triangles.push_back(osim::Triangle{
-                            get_face_vert(face, vert),
-                            get_face_vert(face, vert+1),
-                            center
-                        });
-                    }
-                    // loop back
-                    triangles.push_back(osim::Triangle{
-                        get_face_vert(face, num_vertices-1),
-                        get_face_vert(face, 0),
-                        center
-                    });
-                }
-            }
-
-            out.push_back(osim::Mesh{
+            // the task gets its own copy of `m`: `m` usually belongs to a
+            // temporary decoration array, and if `finish()` throws, that
+            // array can be destroyed while other loads are still running
+            pending_meshes.push_back(Pending_mesh{
                 .transform = transform(m),
                 .scale = scale_factors(m),
                 .rgba = rgba(m),
-                .triangles = std::move(triangles),
+                .loading = mesh_workers().submit([mesh = m]() { return global_mesh_cache().load(mesh); }),
             });
+            if (bodies) {
+                bodies->meshes.push_back(m.getBodyId());
+            }
         }
         void implementArrowGeometry(const DecorativeArrow&) override {
         }
@@ -245,30 +759,424 @@ namespace {
         }
         void implementConeGeometry(const DecorativeCone&) override {
         }
+
+        // waits for all pending meshes to load and emits them. Meshes are
+        // emitted in visitation order, regardless of which finishes first.
+        void finish() {
+            for (Pending_mesh& p : pending_meshes) {
+                Cached_mesh cached = p.loading.get();
+                out.mesh(osim::Mesh{
+                    .transform = p.transform,
+                    .scale = p.scale,
+                    .rgba = p.rgba,
+                    .mesh_id = cached.id,
+                    .data = std::move(cached.data),
+                });
+            }
+            pending_meshes.clear();
+        }
     };
 }
 
+namespace {
+    // Writes body-local geometry (`local`, which is attached to `bodies`) to
+    // `out`, transformed by `body_xforms` (see `body_transforms`)
+    void pose_fixed_geometry(std::span<glm::mat4 const> body_xforms,
+                             osim::Scene const& local,
+                             Body_indices const& bodies,
+                             osim::Scene& out) {
+        // appends `src` to `dest`
+        auto append = [](auto& dest, auto const& src) {
+            dest.insert(dest.end(), src.begin(), src.end());
+        };
+        // grows `dest` by `n` and returns a pointer to the new elements
+        auto extend = [](auto& dest, size_t n) {
+            size_t old_size = dest.size();
+            dest.resize(old_size + n);
+            return dest.data() + old_size;
+        };
+
+        // everything other than transforms/points is pose-independent, so it
+        // is copied wholesale
+        append(out.cylinders.scales, local.cylinders.scales);
+        append(out.cylinders.colors, local.cylinders.colors);
+        compose_transforms(body_xforms, bodies.cylinders, local.cylinders.transforms,
+                           extend(out.cylinders.transforms, local.cylinders.size()));
+
+        append(out.spheres.colors, local.spheres.colors);
+        append(out.spheres.radii, local.spheres.radii);
+        compose_transforms(body_xforms, bodies.spheres, local.spheres.transforms,
+                           extend(out.spheres.transforms, local.spheres.size()));
+
+        append(out.lines.colors, local.lines.colors);
+        compose_points(body_xforms, bodies.lines, local.lines.p1s, extend(out.lines.p1s, local.lines.size()));
+        compose_points(body_xforms, bodies.lines, local.lines.p2s, extend(out.lines.p2s, local.lines.size()));
+
+        // `out` is expected to be empty, so pool indices are still valid
+        out.mesh_pool = local.mesh_pool;
+        append(out.meshes.scales, local.meshes.scales);
+        append(out.meshes.colors, local.meshes.colors);
+        append(out.meshes.pool_indices, local.meshes.pool_indices);
+        compose_transforms(body_xforms, bodies.meshes, local.meshes.transforms,
+                           extend(out.meshes.transforms, local.meshes.size()));
+    }
+}
+
+void osim::Scene::clear() {
+    cylinders.transforms.clear();
+    cylinders.scales.clear();
+    cylinders.colors.clear();
+
+    spheres.transforms.clear();
+    spheres.colors.clear();
+    spheres.radii.clear();
+
+    lines.p1s.clear();
+    lines.p2s.clear();
+    lines.colors.clear();
+
+    meshes.transforms.clear();
+    meshes.scales.clear();
+    meshes.colors.clear();
+    meshes.pool_indices.clear();
+
+    mesh_pool.ids.clear();
+    mesh_pool.data.clear();
+}
+
+namespace {
+    // Finalizes + initializes a freshly-loaded model, returning its working
+    // state
+    State& initialize(Model& model) {
+        model.finalizeFromProperties();
+        model.finalizeConnections();
+
+        // Configure the model.
+
+        model.buildSystem();
+        State& state = model.initSystem();
+        model.initializeState();
+        model.updMatterSubsystem().setShowDefaultGeometry(false);
+        return state;
+    }
+}
+
+struct osim::ModelSession::Impl final {
+    Model model;
+    State* state;
+    std::vector<Coordinate const*> coords;
+    std::vector<Coordinate_info> coord_infos;
+
+    // fixed geometry never changes relative to the body it is attached to,
+    // so it is generated (and its meshes loaded) once, in body coordinates.
+    // Each call to `scene` then only has to move it to wherever its body is.
+    osim::Scene fixed_local;
+    Body_indices fixed_bodies;
+
+    // re-used between calls to `scene`, to avoid reallocating
+    Array_<DecorativeGeometry> decorations;
+    std::vector<glm::mat4> body_xforms;
+
+    // created by the first `integrate_to`, and discarded whenever the state
+    // is set from outside, so the next call starts from the new state
+    std::unique_ptr<RungeKuttaMersonIntegrator> integrator;
+    std::unique_ptr<TimeStepper> stepper;
+
+    Impl(std::string_view path) :
+        model{std::string{path}},
+        state{&initialize(model)} {
+
+        model.realizePosition(*state);
+        {
+            Array_<DecorativeGeometry> fixed;
+            generateGeometry(model, *state, true, fixed);
+            Scene_sink sink{fixed_local};
+            auto visitor = Geometry_visitor{model, *state, sink, fixed_bodies};
+            for (DecorativeGeometry& dg : fixed) {
+                dg.implementGeometry(visitor);
+            }
+            visitor.finish();
+        }
+
+        CoordinateSet const& cs = model.getCoordinateSet();
+        for (int i = 0; i < cs.getSize(); ++i) {
+            Coordinate const& c = cs.get(i);
+            coords.push_back(&c);
+            coord_infos.push_back(Coordinate_info{
+                .name = c.getName(),
+                .min = c.getRangeMin(),
+                .max = c.getRangeMax(),
+                .rotational = c.getMotionType() == Coordinate::Rotational,
+            });
+        }
+    }
+
+    // generates the variable decorations for the current (realized) state
+    // and emits them to `out`. Requires `body_xforms` to be up to date.
+    void emit_variable_geometry(osim::Geometry_sink& out) {
+        decorations.clear();
+        generateGeometry(model, *state, false, decorations);
+
+        auto visitor = Geometry_visitor{model, *state, out, body_xforms};
+        for (DecorativeGeometry& dg : decorations) {
+            dg.implementGeometry(visitor);
+        }
+        visitor.finish();
+    }
+
+    Coordinate const& coord(size_t i) const {
+        if (i >= coords.size()) {
+            throw std::out_of_range{"coordinate index " + std::to_string(i) + " is out of range (the model has " + std::to_string(coords.size()) + " coordinates)"};
+        }
+        return *coords[i];
+    }
+};
+
+osim::ModelSession::ModelSession(std::string_view path) :
+    impl{std::make_unique<Impl>(path)} {
+}
+osim::ModelSession::ModelSession(ModelSession&&) noexcept = default;
+osim::ModelSession& osim::ModelSession::operator=(ModelSession&&) noexcept = default;
+osim::ModelSession::~ModelSession() noexcept = default;
+
+std::span<osim::Coordinate_info const> osim::ModelSession::coordinates() const noexcept {
+    return impl->coord_infos;
+}
+
+std::optional<std::size_t> osim::ModelSession::coordinate_index(std::string_view name) const {
+    for (size_t i = 0; i < impl->coord_infos.size(); ++i) {
+        if (impl->coord_infos[i].name == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+double osim::ModelSession::coordinate_value(std::size_t i) const {
+    return impl->coord(i).getValue(*impl->state);
+}
+
+void osim::ModelSession::set_coordinate_value(std::size_t i, double value) {
+    impl->coord(i).setValue(*impl->state, value, false);
+    impl->stepper.reset();
+}
+
+void osim::ModelSession::set_coordinate_values(std::span<double const> values) {
+    if (values.size() != impl->coords.size()) {
+        throw std::invalid_argument{"got " + std::to_string(values.size()) + " coordinate values, but the model has " + std::to_string(impl->coords.size()) + " coordinates"};
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        impl->coords[i]->setValue(*impl->state, values[i], false);
+    }
+    impl->stepper.reset();
+}
+
+void osim::ModelSession::set_state(SimTK::State const& s) {
+    *impl->state = s;
+    impl->stepper.reset();
+}
+
+SimTK::State const& osim::ModelSession::state() const noexcept {
+    return *impl->state;
+}
+
+double osim::ModelSession::time() const noexcept {
+    return impl->state->getTime();
+}
+
+void osim::ModelSession::integrate_to(double t) {
+    Model& model = impl->model;
+    State& state = *impl->state;
+
+    if (not impl->stepper) {
+        model.equilibrateMuscles(state);
+
+        // interactive playback doesn't need the default (1e-5) accuracy
+        impl->integrator = std::make_unique<RungeKuttaMersonIntegrator>(model.getMultibodySystem());
+        impl->integrator->setAccuracy(1e-3);
+        impl->stepper = std::make_unique<TimeStepper>(model.getMultibodySystem(), *impl->integrator);
+        impl->stepper->initialize(state);
+    }
+
+    impl->stepper->stepTo(t);
+
+    // the integrator advances its own copy of the state
+    state = impl->integrator->getState();
+}
+
+void osim::ModelSession::scene(Scene& out) {
+    Model& model = impl->model;
+    State& state = *impl->state;
+
+    // body transforms (and variable decorations) need the state to be
+    // realized to (at least) positions. This is a no-op if nothing has
+    // changed since the last call.
+    model.realizePosition(state);
+
+    body_transforms(model, state, impl->body_xforms);
+
+    out.clear();
+    pose_fixed_geometry(impl->body_xforms, impl->fixed_local, impl->fixed_bodies, out);
+
+    Scene_sink sink{out};
+    impl->emit_variable_geometry(sink);
+}
+
+void osim::ModelSession::stream(Geometry_sink& out) {
+    Model& model = impl->model;
+    State& state = *impl->state;
+
+    model.realizePosition(state);
+    body_transforms(model, state, impl->body_xforms);
+    std::span<glm::mat4 const> body_xforms = impl->body_xforms;
+
+    // fixed geometry: posed and emitted one element at a time
+    Scene const& local = impl->fixed_local;
+    Body_indices const& bodies = impl->fixed_bodies;
+    for (size_t i = 0; i < local.cylinders.size(); ++i) {
+        out.cylinder(Cylinder{
+            .transform = body_xforms[static_cast<size_t>(bodies.cylinders[i])] * local.cylinders.transforms[i],
+            .scale = local.cylinders.scales[i],
+            .rgba = local.cylinders.colors[i],
+        });
+    }
+    for (size_t i = 0; i < local.spheres.size(); ++i) {
+        out.sphere(Sphere{
+            .transform = body_xforms[static_cast<size_t>(bodies.spheres[i])] * local.spheres.transforms[i],
+            .rgba = local.spheres.colors[i],
+            .radius = local.spheres.radii[i],
+        });
+    }
+    for (size_t i = 0; i < local.lines.size(); ++i) {
+        glm::mat4 const& xform = body_xforms[static_cast<size_t>(bodies.lines[i])];
+        out.line(Line{
+            .p1 = glm::vec3{xform * glm::vec4{local.lines.p1s[i], 1.0f}},
+            .p2 = glm::vec3{xform * glm::vec4{local.lines.p2s[i], 1.0f}},
+            .rgba = local.lines.colors[i],
+        });
+    }
+    for (size_t i = 0; i < local.meshes.size(); ++i) {
+        std::uint32_t pool_idx = local.meshes.pool_indices[i];
+        out.mesh(Mesh{
+            .transform = body_xforms[static_cast<size_t>(bodies.meshes[i])] * local.meshes.transforms[i],
+            .scale = local.meshes.scales[i],
+            .rgba = local.meshes.colors[i],
+            .mesh_id = local.mesh_pool.ids[pool_idx],
+            .data = local.mesh_pool.data[pool_idx],
+        });
+    }
+
+    impl->emit_variable_geometry(out);
+}
+
+void osim::scene_in(std::string_view path, Scene& out) {
+    ModelSession{path}.scene(out);
+}
+
+osim::Scene osim::scene_in(std::string_view path) {
+    Scene rv;
+    scene_in(path, rv);
+    return rv;
+}
+
+void osim::geometry_in(std::string_view path, Geometry_sink& out) {
+    ModelSession{path}.stream(out);
+}
+
 std::vector<osim::Geometry> osim::geometry_in(std::string_view path) {
-    Model model{std::string{path}};
-    model.finalizeFromProperties();
-    model.finalizeConnections();
+    std::vector<Geometry> rv;
+    Vector_sink sink{rv};
+    geometry_in(path, sink);
+    return rv;
+}
 
-    // Configure the model.
+osim::Transform_benchmark osim::benchmark_transforms(std::string_view model_path,
+                                                     std::size_t min_decorations,
+                                                     int iterations) {
+    Model model{std::string{model_path}};
+    State& state = initialize(model);
+    model.realizePosition(state);
 
-    model.buildSystem();
-    State& state = model.initSystem();
-    model.initializeState();
-    model.updMatterSubsystem().setShowDefaultGeometry(false);
+    // the model's decorations, repeated until there are enough of them
+    Array_<DecorativeGeometry> decorations;
+    generateGeometry(model, state, true, decorations);
+    generateGeometry(model, state, false, decorations);
+    if (decorations.empty()) {
+        throw std::runtime_error{std::string{model_path} + ": model has no decorations to benchmark"};
+    }
+    for (size_t i = 0; decorations.size() < min_decorations; ++i) {
+        DecorativeGeometry copy = decorations[static_cast<unsigned>(i)];
+        decorations.push_back(copy);
+    }
+    size_t n = decorations.size();
 
-    DynamicDecorationGenerator dg{&model};
-    Array_<DecorativeGeometry> tmp;
-    dg.generateDecorations(state, tmp);
+    SimbodyMatterSubsystem const& ms = model.getSystem().getMatterSubsystem();
+    std::vector<glm::mat4> per_decoration_out(n);
+    std::vector<glm::mat4> batched_out(n);
+    std::vector<glm::mat4> scalar_out(n);
 
-    auto rv = std::vector<osim::Geometry>{};
-    auto visitor = Geometry_visitor{model, state, rv};
-    for (DecorativeGeometry& dg : tmp) {
-        dg.implementGeometry(visitor);
+    // per-decoration path: for every decoration, look up its body, compose in
+    // double precision, then convert
+    auto per_decoration = [&]() {
+        for (size_t i = 0; i < n; ++i) {
+            DecorativeGeometry const& dg = decorations[static_cast<unsigned>(i)];
+            MobilizedBody const& mobod = ms.getMobilizedBody(MobilizedBodyIndex(dg.getBodyId()));
+            per_decoration_out[i] = to_mat4(mobod.getBodyTransform(state) * dg.getTransform());
+        }
+    };
+
+    // batched path: body-local transforms are pose-independent, so (as with
+    // the fixed pass) they are converted once up front. Per pose, there is one
+    // conversion per body and one float mat4 product per decoration.
+    std::vector<glm::mat4> locals(n);
+    std::vector<int> body_indices(n);
+    for (size_t i = 0; i < n; ++i) {
+        DecorativeGeometry const& dg = decorations[static_cast<unsigned>(i)];
+        locals[i] = to_mat4(dg.getTransform());
+        body_indices[i] = dg.getBodyId();
     }
+    std::vector<glm::mat4> body_xforms;
+    auto batched = [&]() {
+        body_transforms(model, state, body_xforms);
+        compose_transforms(body_xforms, body_indices, locals, batched_out.data());
+    };
+    auto batched_scalar = [&]() {
+        body_transforms(model, state, body_xforms);
+        compose_transforms_scalar(body_xforms, body_indices, locals, scalar_out.data());
+    };
 
+    auto time_us = [iterations](auto&& f) {
+        f();  // warmup
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            f();
+        }
+        auto dt = std::chrono::high_resolution_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(dt).count() / std::max(iterations, 1);
+    };
+
+    Transform_benchmark rv{};
+    rv.num_decorations = n;
+    rv.num_bodies = static_cast<std::size_t>(ms.getNumBodies());
+    rv.per_decoration_us = time_us(per_decoration);
+    rv.batched_us = time_us(batched);
+    rv.batched_scalar_us = time_us(batched_scalar);
+#ifdef OSIM_COMPOSE_SSE2
+    rv.compose_isa = "SSE2";
+#else
+    rv.compose_isa = "scalar (no SSE2 on this target)";
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                float diff = std::abs(per_decoration_out[i][col][row] - batched_out[i][col][row]);
+                rv.max_abs_difference = std::max(rv.max_abs_difference, diff);
+            }
+        }
+    }
     return rv;
 }
+
+osim::Mesh_cache_stats osim::mesh_cache_stats() {
+    return global_mesh_cache().stats();
+}
@@ -5,10 +5,19 @@
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <variant>
 
+namespace SimTK {
+    class State;
+}
+
 namespace osim {
     struct Cylinder final {
         glm::mat4 transform;
@@ -46,17 +55,44 @@ namespace osim {
     struct Text final {
     };
 
-    struct Triangle {
-        glm::vec3 p1;
-        glm::vec3 p2;
-        glm::vec3 p3;
+    // Vertex of a triangle mesh. Tightly packed, so that arrays of these can
+    // be handed straight to OpenGL (or written to/mapped from disk)
+    struct Mesh_vertex final {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+    static_assert(sizeof(Mesh_vertex) == 6*sizeof(float));
+
+    // Indices into a mesh's vertex array, 3 per triangle. 16-bit indices are
+    // used whenever the mesh has few enough vertices, because they halve the
+    // size of the index buffer.
+    using Mesh_indices = std::variant<
+        std::span<std::uint16_t const>,
+        std::span<std::uint32_t const>
+    >;
+
+    // Indexed triangle mesh with per-vertex normals. Each vertex is stored
+    // once, no matter how many faces share it.
+    //
+    // `vertices` and `indices` are views into `storage`, which is either heap
+    // memory or a memory-mapped cache file (see mesh_cache.hpp)
+    struct Mesh_data final {
+        std::span<Mesh_vertex const> vertices;
+        Mesh_indices indices;
+        std::shared_ptr<void const> storage;
     };
 
+    // Process-unique handle to a mesh in the mesh cache. Decorations that use
+    // the same mesh (same file contents) have the same handle, so downstream
+    // code (e.g. GPU uploads) can also be done once per handle.
+    using Mesh_id = std::size_t;
+
     struct Mesh final {
         glm::mat4 transform;
         glm::vec3 scale;
         glm::vec4 rgba;
-        std::vector<Triangle> triangles;
+        Mesh_id mesh_id;
+        std::shared_ptr<Mesh_data const> data;
     };
 
     struct Arrow final {
@@ -75,7 +111,187 @@ namespace osim {
         Mesh
     >;
 
+    // Distinct meshes used by a scene. Mesh instances refer to entries by
+    // their index in the pool, so each mesh appears here once no matter how
+    // many decorations use it.
+    struct Mesh_pool final {
+        std::vector<Mesh_id> ids;
+        std::vector<std::shared_ptr<Mesh_data const>> data;
+
+        std::size_t size() const noexcept {
+            return ids.size();
+        }
+    };
+
+    // Structure-of-arrays form of the geometry in a model. Each geometry type
+    // is a set of parallel, tightly packed arrays (element `i` of each array
+    // belongs to the same instance), so consumers can stream through just the
+    // attributes they need without any per-element variant dispatch.
+    struct Scene final {
+        struct Cylinders final {
+            std::vector<glm::mat4> transforms;
+            std::vector<glm::vec3> scales;
+            std::vector<glm::vec4> colors;
+
+            std::size_t size() const noexcept {
+                return transforms.size();
+            }
+        } cylinders;
+
+        struct Spheres final {
+            std::vector<glm::mat4> transforms;
+            std::vector<glm::vec4> colors;
+            std::vector<float> radii;
+
+            std::size_t size() const noexcept {
+                return transforms.size();
+            }
+        } spheres;
+
+        struct Lines final {
+            std::vector<glm::vec3> p1s;
+            std::vector<glm::vec3> p2s;
+            std::vector<glm::vec4> colors;
+
+            std::size_t size() const noexcept {
+                return p1s.size();
+            }
+        } lines;
+
+        struct Meshes final {
+            std::vector<glm::mat4> transforms;
+            std::vector<glm::vec3> scales;
+            std::vector<glm::vec4> colors;
+            std::vector<std::uint32_t> pool_indices;  // into `mesh_pool`
+
+            std::size_t size() const noexcept {
+                return transforms.size();
+            }
+        } meshes;
+
+        Mesh_pool mesh_pool;
+
+        // empties all arrays, but keeps their capacity
+        void clear();
+    };
+
+    // Writes the geometry in the model at `model_path` into `out` (which is
+    // cleared first, so a scene can be re-used across loads without
+    // reallocating)
+    void scene_in(std::string_view model_path, Scene& out);
+    Scene scene_in(std::string_view model_path);
+
+    // Receives extracted geometry one element at a time, as it is extracted.
+    // Lets callers write geometry straight to wherever it is going (e.g. a
+    // mapped GPU buffer) without any intermediate containers.
+    //
+    // Meshes are loaded in parallel, so `mesh` calls may arrive after calls
+    // for geometry that was extracted later. The references passed to each
+    // method are only valid for the duration of the call.
+    class Geometry_sink {
+    public:
+        virtual ~Geometry_sink() noexcept = default;
+        virtual void cylinder(Cylinder const&) = 0;
+        virtual void sphere(Sphere const&) = 0;
+        virtual void line(Line const&) = 0;
+        virtual void mesh(Mesh const&) = 0;
+    };
+
+    // Streams the geometry in the model at `model_path` into `out`
+    void geometry_in(std::string_view model_path, Geometry_sink& out);
+
+    // Returns the same geometry as `geometry_in(path, sink)`, as one variant
+    // per element
     std::vector<Geometry> geometry_in(std::string_view model_path);
+
+    struct Coordinate_info final {
+        std::string name;
+        double min;
+        double max;
+        bool rotational;  // value is an angle (radians), rather than a length
+    };
+
+    // A loaded, initialized model plus its current state
+    //
+    // Loading + initializing a model (`buildSystem`, `initSystem`) is
+    // expensive, so a session does it once up front. After that, changing the
+    // pose (coordinate values or a whole `SimTK::State`) and re-extracting the
+    // scene for it are cheap enough to do every frame.
+    class ModelSession final {
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+
+    public:
+        // throws if the model cannot be loaded or initialized
+        explicit ModelSession(std::string_view model_path);
+        ModelSession(ModelSession&&) noexcept;
+        ModelSession& operator=(ModelSession&&) noexcept;
+        ~ModelSession() noexcept;
+
+        std::span<Coordinate_info const> coordinates() const noexcept;
+
+        // index of the named coordinate in `coordinates()`, if it exists
+        std::optional<std::size_t> coordinate_index(std::string_view name) const;
+
+        double coordinate_value(std::size_t i) const;
+
+        // setters throw if `i` is out of bounds. Constraints are not enforced,
+        // so that the model goes exactly where the caller puts it
+        void set_coordinate_value(std::size_t i, double value);
+        void set_coordinate_values(std::span<double const> values);  // one per coordinate
+        void set_state(SimTK::State const&);
+
+        SimTK::State const& state() const noexcept;
+
+        // simulation time of the current state
+        double time() const noexcept;
+
+        // runs a forward-dynamic simulation of the current state until its
+        // time is `t`. The first call (or the first call after any setter)
+        // equilibrates muscles and starts a fresh integrator; later calls
+        // continue from where the last one stopped. Throws if integration
+        // fails.
+        void integrate_to(double t);
+
+        // writes the geometry for the current state into `out` (which is
+        // cleared first). Meshes come from the mesh cache, so repeated calls
+        // only re-compute transforms, colors, etc.
+        void scene(Scene& out);
+
+        // streams the geometry for the current state into `out`
+        void stream(Geometry_sink& out);
+    };
+
+    struct Mesh_cache_stats final {
+        std::size_t hits;
+        std::size_t disk_hits;  // misses that were loaded from the disk cache
+        std::size_t misses;
+        std::size_t entries;
+    };
+
+    // Results of `benchmark_transforms`. Times are per pose (i.e. for all of
+    // the decorations), averaged over all iterations
+    struct Transform_benchmark final {
+        std::size_t num_decorations;
+        std::size_t num_bodies;
+        double per_decoration_us;  // body lookup + double-precision compose per decoration
+        double batched_us;         // body-transform table + batched float compose
+        double batched_scalar_us;  // the same, with the plain glm compose loop
+        char const* compose_isa;   // what the batched compose ran with (e.g. "SSE2")
+        float max_abs_difference;  // largest element-wise difference between per-decoration and batched
+    };
+
+    // Times computing the world transforms of every decoration in a model,
+    // both one decoration at a time and via a per-state body-transform table.
+    // The model's decorations are repeated until there are at least
+    // `min_decorations` of them.
+    Transform_benchmark benchmark_transforms(std::string_view model_path,
+                                             std::size_t min_decorations,
+                                             int iterations);
+
+    // Returns hit/miss statistics for the process-wide mesh cache, which
+    // `geometry_in` uses to triangulate each distinct mesh file only once
+    Mesh_cache_stats mesh_cache_stats();
 }
 
 #endif // OPENSIM_WRAPPER_HPP
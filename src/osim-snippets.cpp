@@ -5,18 +5,27 @@ static const char* usage = R"(usage: osim-snippets <command>
 
 commands:
     show         show an osim file in a GUI
+    render       render osim files to images, without a window
     sizes        print memory usage of various OpenSim objects
     expt_cable   cable wrapping experiment
     expt_pendu   pendulum experiment
     expt_wrapp   wrapping experiment
+    expt_party   cable-over-bones demo; records and replays its trajectory
+    sweep        headless parameter sweep of the wrapping experiment
+    warm_cache   pre-populate the on-disk mesh cache for a directory of models
+    bench_xforms benchmark decoration transform computation
 )";
 
 int oss_show(int argc, char** argv);
+int oss_render(int argc, char** argv);
 int oss_sizes(int argc, char** argv);
 int oss_expt_cable(int argc, char** argv);
 int oss_expt_pendu(int argc, char** argv);
 int oss_expt_wrapp(int argc, char** argv);
+int oss_sweep(int argc, char** argv);
 int oss_expt_party(int argc, char** argv);
+int oss_warm_cache(int argc, char** argv);
+int oss_bench_xforms(int argc, char** argv);
 
 struct Cmd final {
     const char* name;
@@ -25,7 +34,12 @@ struct Cmd final {
 
 static const Cmd cmds[] = {
     { "expt_wrap", oss_expt_wrapp },
+    { "sweep", oss_sweep },
+    { "expt_party", oss_expt_party },
     { "show", oss_show },
+    { "render", oss_render },
+    { "warm_cache", oss_warm_cache },
+    { "bench_xforms", oss_bench_xforms },
 };
 
 int main(int argc, char** argv) {
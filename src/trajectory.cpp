@@ -0,0 +1,347 @@
+#include "trajectory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::literals::string_literals::operator""s;
+
+namespace {
+    constexpr char traj_magic[8] = {'O', 'S', 'T', 'R', 'A', 'J', '\0', '\0'};
+    constexpr std::uint32_t traj_version = 1;
+    constexpr std::uint32_t chunk_magic = 0x4b4e4843;  // "CHNK"
+
+    // Header at the start of every trajectory file. index_offset is 0 until
+    // the writer finishes the file.
+    struct File_header final {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t num_columns;
+        std::uint32_t rows_per_chunk;
+        std::uint32_t reserved;
+        std::uint64_t num_rows;
+        std::uint64_t num_chunks;
+        std::uint64_t chunks_offset;
+        std::uint64_t index_offset;
+    };
+    static_assert(sizeof(File_header) % 8 == 0);
+
+    // Precedes each chunk's column arrays. Chunks are self-describing so that
+    // an unfinished file (which has no index) can still be read.
+    struct Chunk_header final {
+        std::uint32_t magic;
+        std::uint32_t num_rows;
+        double t_begin;
+        double t_end;
+        std::uint64_t first_row;
+    };
+    static_assert(sizeof(Chunk_header) % 8 == 0);
+
+    std::uint64_t align8(std::uint64_t n) {
+        return (n + 7) & ~static_cast<std::uint64_t>(7);
+    }
+}
+
+struct osim::Trajectory_writer::Index_entry final {
+    double t_begin;
+    double t_end;
+    std::uint64_t offset;
+    std::uint64_t first_row;
+};
+
+osim::Trajectory_writer::Trajectory_writer(std::filesystem::path const& path_,
+                                           std::vector<std::string> const& column_names,
+                                           std::uint32_t rows_per_chunk) :
+    out{path_, std::ios::binary | std::ios::trunc},
+    path{path_},
+    ncols{column_names.size()},
+    chunk_capacity{rows_per_chunk},
+    chunk(column_names.size() * rows_per_chunk) {
+
+    if (ncols == 0 or column_names[0] != "time") {
+        throw std::runtime_error{path.string() + ": the first trajectory column must be \"time\""};
+    }
+    if (chunk_capacity == 0) {
+        throw std::runtime_error{path.string() + ": chunks must hold at least one row"};
+    }
+    if (not out) {
+        throw std::runtime_error{path.string() + ": cannot open for writing"};
+    }
+
+    // the header is rewritten with the final counts + index offset by finish()
+    File_header h{};
+    std::memcpy(h.magic, traj_magic, sizeof(traj_magic));
+    h.version = traj_version;
+    h.num_columns = static_cast<std::uint32_t>(ncols);
+    h.rows_per_chunk = chunk_capacity;
+    out.write(reinterpret_cast<char const*>(&h), sizeof(h));
+
+    for (std::string const& name : column_names) {
+        auto len = static_cast<std::uint32_t>(name.size());
+        out.write(reinterpret_cast<char const*>(&len), sizeof(len));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+    static constexpr char zeroes[8] = {};
+    auto pos = static_cast<std::uint64_t>(out.tellp());
+    out.write(zeroes, static_cast<std::streamsize>(align8(pos) - pos));
+
+    if (not out) {
+        throw std::runtime_error{path.string() + ": write failed"};
+    }
+}
+
+osim::Trajectory_writer::~Trajectory_writer() noexcept {
+    try {
+        finish();
+    } catch (std::exception const& ex) {
+        std::cerr << "trajectory: " << ex.what() << std::endl;
+    }
+}
+
+void osim::Trajectory_writer::flush_chunk() {
+    if (chunk_rows == 0) {
+        return;
+    }
+
+    Chunk_header ch{};
+    ch.magic = chunk_magic;
+    ch.num_rows = chunk_rows;
+    ch.t_begin = chunk[0];
+    ch.t_end = chunk[chunk_rows - 1];
+    ch.first_row = rows_written;
+
+    index.push_back(Index_entry{ch.t_begin, ch.t_end, static_cast<std::uint64_t>(out.tellp()), rows_written});
+
+    out.write(reinterpret_cast<char const*>(&ch), sizeof(ch));
+    for (std::size_t col = 0; col < ncols; ++col) {
+        out.write(reinterpret_cast<char const*>(chunk.data() + col * chunk_capacity),
+                  static_cast<std::streamsize>(chunk_rows * sizeof(double)));
+    }
+
+    // flushed so that a crash loses, at most, the chunk being filled
+    out.flush();
+    if (not out) {
+        throw std::runtime_error{path.string() + ": write failed"};
+    }
+
+    rows_written += chunk_rows;
+    chunk_rows = 0;
+}
+
+void osim::Trajectory_writer::append(std::span<double const> row) {
+    if (finished) {
+        throw std::runtime_error{path.string() + ": cannot append to a finished trajectory"};
+    }
+    if (row.size() != ncols) {
+        throw std::runtime_error{path.string() + ": expected " + std::to_string(ncols) + " values, got " + std::to_string(row.size())};
+    }
+    if (num_rows() > 0 and row[0] < last_time) {
+        throw std::runtime_error{path.string() + ": trajectory times must not decrease"};
+    }
+    last_time = row[0];
+
+    for (std::size_t col = 0; col < ncols; ++col) {
+        chunk[col * chunk_capacity + chunk_rows] = row[col];
+    }
+    if (++chunk_rows == chunk_capacity) {
+        flush_chunk();
+    }
+}
+
+void osim::Trajectory_writer::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+
+    flush_chunk();
+
+    File_header h{};
+    std::memcpy(h.magic, traj_magic, sizeof(traj_magic));
+    h.version = traj_version;
+    h.num_columns = static_cast<std::uint32_t>(ncols);
+    h.rows_per_chunk = chunk_capacity;
+    h.num_rows = rows_written;
+    h.num_chunks = index.size();
+    h.index_offset = static_cast<std::uint64_t>(out.tellp());
+    h.chunks_offset = index.empty() ? h.index_offset : index.front().offset;
+
+    out.write(reinterpret_cast<char const*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(Index_entry)));
+    out.seekp(0);
+    out.write(reinterpret_cast<char const*>(&h), sizeof(h));
+    out.close();
+
+    if (not out) {
+        throw std::runtime_error{path.string() + ": write failed"};
+    }
+}
+
+osim::Trajectory::Trajectory(std::filesystem::path const& path) :
+    file{std::make_shared<Mapped_file>(path)} {
+
+    auto invalid = [&](char const* why) {
+        return std::runtime_error{path.string() + ": not a valid trajectory: "s + why};
+    };
+
+    std::size_t size = file->size();
+    std::byte const* base = file->data();
+
+    if (size < sizeof(File_header)) {
+        throw invalid("too small");
+    }
+    File_header h;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, traj_magic, sizeof(traj_magic)) != 0 or h.version != traj_version) {
+        throw invalid("bad magic or version");
+    }
+    if (h.num_columns == 0 or h.rows_per_chunk == 0) {
+        throw invalid("bad header");
+    }
+    rows_per_chunk = h.rows_per_chunk;
+
+    // column names
+    std::size_t pos = sizeof(File_header);
+    for (std::uint32_t i = 0; i < h.num_columns; ++i) {
+        std::uint32_t len;
+        if (pos + sizeof(len) > size) {
+            throw invalid("truncated column names");
+        }
+        std::memcpy(&len, base + pos, sizeof(len));
+        pos += sizeof(len);
+        if (pos + len > size) {
+            throw invalid("truncated column names");
+        }
+        names.emplace_back(reinterpret_cast<char const*>(base + pos), len);
+        pos += len;
+    }
+    pos = align8(pos);
+
+    // validates the chunk at `offset` and appends it. Returns the offset just
+    // past it, or 0 if it's invalid.
+    auto add_chunk = [&](std::uint64_t offset) -> std::uint64_t {
+        if (offset % 8 != 0 or offset + sizeof(Chunk_header) > size) {
+            return 0;
+        }
+        Chunk_header ch;
+        std::memcpy(&ch, base + offset, sizeof(ch));
+        std::uint64_t end = offset + sizeof(Chunk_header) + std::uint64_t{ch.num_rows} * h.num_columns * sizeof(double);
+        if (ch.magic != chunk_magic or ch.num_rows == 0 or ch.num_rows > rows_per_chunk or end > size or ch.first_row != rows) {
+            return 0;
+        }
+        chunks_.push_back(Chunk{
+            .t_begin = ch.t_begin,
+            .t_end = ch.t_end,
+            .first_row = ch.first_row,
+            .num_rows = ch.num_rows,
+            .data = reinterpret_cast<double const*>(base + offset + sizeof(Chunk_header)),
+        });
+        rows += ch.num_rows;
+        return end;
+    };
+
+    if (h.index_offset != 0) {
+        if (h.index_offset % 8 != 0 or h.index_offset + h.num_chunks * sizeof(Trajectory_writer::Index_entry) > size) {
+            throw invalid("bad chunk index");
+        }
+        chunks_.reserve(h.num_chunks);
+        for (std::uint64_t i = 0; i < h.num_chunks; ++i) {
+            Trajectory_writer::Index_entry e;
+            std::memcpy(&e, base + h.index_offset + i * sizeof(e), sizeof(e));
+            if (add_chunk(e.offset) == 0) {
+                throw invalid("bad chunk");
+            }
+        }
+        if (rows != h.num_rows) {
+            throw invalid("row count mismatch");
+        }
+        complete = true;
+    } else {
+        // unfinished file: rebuild the index from the chunks that were fully
+        // written
+        for (std::uint64_t offset = pos; offset != 0 and offset < size;) {
+            offset = add_chunk(offset);
+        }
+    }
+
+    // chunk_of_row relies on this
+    for (std::size_t i = 0; i + 1 < chunks_.size(); ++i) {
+        if (chunks_[i].num_rows != rows_per_chunk) {
+            throw invalid("partial chunk before the last chunk");
+        }
+    }
+}
+
+std::size_t osim::Trajectory::column_index(std::string_view name) const {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+        throw std::runtime_error{"trajectory has no column called " + std::string{name}};
+    }
+    return static_cast<std::size_t>(it - names.begin());
+}
+
+double osim::Trajectory::start_time() const noexcept {
+    return chunks_.empty() ? 0.0 : chunks_.front().t_begin;
+}
+
+double osim::Trajectory::end_time() const noexcept {
+    return chunks_.empty() ? 0.0 : chunks_.back().t_end;
+}
+
+std::size_t osim::Trajectory::find_chunk(double t) const noexcept {
+    std::size_t n = chunks_.size();
+    if (n <= 1 or t <= start_time()) {
+        return 0;
+    }
+    if (t >= end_time()) {
+        return n - 1;
+    }
+
+    // guess, assuming the trajectory is evenly sampled, then walk to the
+    // right chunk. Fall back to a binary search if the guess is far off.
+    auto guess = static_cast<std::size_t>((t - start_time()) / (end_time() - start_time()) * static_cast<double>(n));
+    guess = std::min(guess, n - 1);
+    for (int steps = 0; steps < 4; ++steps) {
+        if (chunks_[guess].t_begin > t) {
+            --guess;  // can't underflow: chunks_[0].t_begin < t
+        } else if (guess + 1 < n and chunks_[guess + 1].t_begin <= t) {
+            ++guess;
+        } else {
+            return guess;
+        }
+    }
+
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), t, [](double v, Chunk const& c) {
+        return v < c.t_begin;
+    });
+    return static_cast<std::size_t>(it - chunks_.begin()) - 1;
+}
+
+std::uint64_t osim::Trajectory::find_row(double t) const noexcept {
+    if (chunks_.empty()) {
+        return 0;
+    }
+    Chunk const& c = chunks_[find_chunk(t)];
+    auto times = c.times();
+    auto it = std::upper_bound(times.begin(), times.end(), t);
+    std::uint64_t i = it == times.begin() ? 0 : static_cast<std::uint64_t>(it - times.begin()) - 1;
+    return c.first_row + i;
+}
+
+osim::Trajectory::Chunk const& osim::Trajectory::chunk_of_row(std::uint64_t row) const noexcept {
+    return chunks_[static_cast<std::size_t>(row / rows_per_chunk)];
+}
+
+double osim::Trajectory::at(std::uint64_t row, std::size_t col) const noexcept {
+    Chunk const& c = chunk_of_row(row);
+    return c.column(col)[static_cast<std::size_t>(row - c.first_row)];
+}
+
+void osim::Trajectory::read_row(std::uint64_t row, std::span<double> out) const noexcept {
+    Chunk const& c = chunk_of_row(row);
+    auto i = static_cast<std::size_t>(row - c.first_row);
+    for (std::size_t col = 0; col < names.size(); ++col) {
+        out[col] = c.column(col)[i];
+    }
+}
@@ -0,0 +1,175 @@
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include "mesh_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Chunked, column-oriented trajectory files
+//
+// A trajectory is a table of doubles: one row per recorded state, and one
+// column per recorded quantity (time, each q, each u, and any outputs, such as
+// a cable's length). Column 0 is always time, which must not decrease from
+// row to row.
+//
+// Rows are grouped into fixed-size chunks. Each chunk is stored column-major
+// (all of its times, then all of its values for column 1, and so on), so one
+// quantity over a time range is a contiguous array in the file. Because of
+// this, readers can memory-map the file and use columns in place, with no
+// parsing or copying. A chunk index at the end of the file holds each chunk's
+// time range, so seeking by time does not scan the file.
+//
+// Layout:
+//
+//     header
+//     column names (each is a u32 length, then UTF-8 bytes)
+//     chunk*  (each is a chunk header, then num_columns arrays of num_rows doubles)
+//     chunk index (one entry per chunk)
+//
+// Everything is 8-byte aligned. As with the mesh cache, files are
+// native-endian and are not meant to be portable between machines.
+namespace osim {
+    // Appends rows to a new trajectory file
+    //
+    // Rows are buffered in memory until a chunk is full, and then that chunk
+    // is written out. If the writer is never finished (e.g. because the
+    // process crashes), the file has no index. Readers can still open it by
+    // scanning its chunks, and only the last, partial chunk is lost.
+    class Trajectory_writer final {
+        std::ofstream out;
+        std::filesystem::path path;
+        std::size_t ncols;
+        std::uint32_t chunk_capacity;
+
+        // column-major: ncols arrays of chunk_capacity values
+        std::vector<double> chunk;
+        std::uint32_t chunk_rows = 0;
+
+        // on-disk chunk index entry (defined in trajectory.cpp)
+        struct Index_entry;
+        friend class Trajectory;
+        std::vector<Index_entry> index;
+        std::uint64_t rows_written = 0;
+        double last_time = 0;
+        bool finished = false;
+
+        void flush_chunk();
+
+    public:
+        // throws if the file can't be created
+        Trajectory_writer(std::filesystem::path const& path,
+                          std::vector<std::string> const& column_names,
+                          std::uint32_t rows_per_chunk = 1024);
+        Trajectory_writer(Trajectory_writer const&) = delete;
+        Trajectory_writer& operator=(Trajectory_writer const&) = delete;
+
+        // finishes the file, if it wasn't already. Errors are reported on
+        // stderr.
+        ~Trajectory_writer() noexcept;
+
+        // `row` must have one value per column, with row[0] being the time
+        void append(std::span<double const> row);
+
+        // writes the last (partial) chunk and the chunk index. No more rows
+        // can be appended afterwards.
+        void finish();
+
+        std::size_t num_columns() const noexcept {
+            return ncols;
+        }
+
+        std::uint64_t num_rows() const noexcept {
+            return rows_written + chunk_rows;
+        }
+    };
+
+    // A memory-mapped trajectory file
+    class Trajectory final {
+    public:
+        struct Chunk final {
+            double t_begin;
+            double t_end;
+            std::uint64_t first_row;
+            std::uint32_t num_rows;
+            double const* data;  // column-major, in the mapping
+
+            // values of column `col` for this chunk's rows
+            std::span<double const> column(std::size_t col) const noexcept {
+                return {data + col * num_rows, num_rows};
+            }
+
+            std::span<double const> times() const noexcept {
+                return column(0);
+            }
+        };
+
+    private:
+        std::shared_ptr<Mapped_file> file;
+        std::vector<std::string> names;
+        std::vector<Chunk> chunks_;
+        std::uint64_t rows = 0;
+        std::uint32_t rows_per_chunk = 0;  // every chunk but the last is full
+        bool complete = false;
+
+    public:
+        // throws if the file can't be mapped or isn't a valid trajectory
+        Trajectory(std::filesystem::path const&);
+
+        std::vector<std::string> const& column_names() const noexcept {
+            return names;
+        }
+
+        std::size_t num_columns() const noexcept {
+            return names.size();
+        }
+
+        // throws if there is no column called `name`
+        std::size_t column_index(std::string_view name) const;
+
+        std::uint64_t num_rows() const noexcept {
+            return rows;
+        }
+
+        std::span<Chunk const> chunks() const noexcept {
+            return chunks_;
+        }
+
+        // false if the writer didn't finish the file, in which case the index
+        // was rebuilt by scanning the file's chunks
+        bool has_index() const noexcept {
+            return complete;
+        }
+
+        double start_time() const noexcept;
+        double end_time() const noexcept;
+
+        // index of the chunk containing time `t` (clamped to the
+        // trajectory's time range)
+        //
+        // O(1) for evenly-sampled trajectories, which is what periodic
+        // reporters record. The chunk is first guessed from `t`'s position in
+        // the trajectory's time range, and then the guess is corrected.
+        std::size_t find_chunk(double t) const noexcept;
+
+        // index of the last row with a time <= `t` (or the first row, if `t`
+        // is before the start of the trajectory)
+        std::uint64_t find_row(double t) const noexcept;
+
+        Chunk const& chunk_of_row(std::uint64_t row) const noexcept;
+
+        double at(std::uint64_t row, std::size_t col) const noexcept;
+
+        // copies row `row` into `out`, which must have num_columns() elements
+        void read_row(std::uint64_t row, std::span<double> out) const noexcept;
+    };
+}
+
+#endif // TRAJECTORY_HPP
@@ -0,0 +1,66 @@
+#include "opensim_wrapper.hpp"
+#include "mesh_cache.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+static const char* usage = R"(usage: osim-snippets warm_cache <dir|model.osim>...
+
+Loads every .osim model found (recursively) in the given directories, so that
+all of the meshes they use are written to the on-disk mesh cache. Subsequent
+`show`s of those models map the cached meshes rather than parsing them.
+
+The cache is written to $OSIM_SNIPPETS_MESH_CACHE, if set.
+)";
+
+int oss_warm_cache(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << usage << std::endl;
+        return -1;
+    }
+
+    std::vector<std::filesystem::path> models;
+    for (int i = 2; i < argc; ++i) {
+        std::filesystem::path p{argv[i]};
+        if (std::filesystem::is_directory(p)) {
+            for (auto const& entry : std::filesystem::recursive_directory_iterator{p}) {
+                if (entry.is_regular_file() and entry.path().extension() == ".osim") {
+                    models.push_back(entry.path());
+                }
+            }
+        } else {
+            models.push_back(p);
+        }
+    }
+
+    std::cout << "warming " << osim::disk_cache_dir().string() << " with " << models.size() << " models" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    int failures = 0;
+    for (std::filesystem::path const& model : models) {
+        auto model_start = std::chrono::high_resolution_clock::now();
+        try {
+            osim::scene_in(model.string());
+        } catch (std::exception const& ex) {
+            std::cerr << model.string() << ": failed: " << ex.what() << std::endl;
+            ++failures;
+            continue;
+        }
+        auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - model_start);
+        std::cout << model.string() << ": " << dt.count() << " ms" << std::endl;
+    }
+    auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    osim::Mesh_cache_stats stats = osim::mesh_cache_stats();
+    std::cout << std::endl
+              << "meshes:    " << stats.entries << std::endl
+              << "hits:      " << stats.hits << std::endl
+              << "disk hits: " << stats.disk_hits << std::endl
+              << "misses:    " << stats.misses << " (triangulated + written)" << std::endl
+              << "failures:  " << failures << std::endl
+              << "took:      " << dt.count() << " ms" << std::endl;
+
+    return failures == 0 ? 0 : -1;
+}